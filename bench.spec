@@ -0,0 +1,22 @@
+# Sweep specification for align_bench_sweep and bench.sh.
+# Every line has the form 'key = values'. All combinations of the listed values are executed for every data set.
+
+output        = res.csv
+repetition    = 3
+warmup        = 1
+alphabet      = dna
+method        = global
+mode          = pair
+
+# dataset = simulate <#sequences> <min length> <max length> [uniform|normal]
+# dataset = files <query.fa> <database.fa>
+# dataset = suite <name>, a data set built by align_bench_datasets in dataset-dir, which sets alphabet and mode
+dataset       = simulate 1000 1000 1100
+dataset       = simulate 1000 10000 11000
+dataset       = simulate 100 50000 55000
+
+policy        = seq seq_vec par par_vec wave wave_vec
+threads       = 1 2 4 8 16
+block-size    = 50 100 150 200
+jobs          = 16
+integer-width = 16 32
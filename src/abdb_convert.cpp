@@ -0,0 +1,119 @@
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <seqan/basic.h>
+#include <seqan/arg_parse.h>
+#include <seqan/sequence.h>
+#include <seqan/stream.h>
+#include <seqan/seq_io.h>
+
+#include "align_bench_options.hpp"
+#include "parallel_reader.hpp"
+#include "sequence_database.hpp"
+#include "simd_layout.hpp"
+
+using namespace seqan;
+
+struct options
+{
+    std::string in_file;
+    std::string out_file;
+    std::string alphabet;
+    unsigned    reader_threads;
+    unsigned    simd_width{0};
+    std::string binning;
+};
+
+/*
+ * @fn parsCommandLine
+ *
+ * @brief Parses the command line arguments and options.
+ *
+ * @signature ParseResult parseCommandLine(options, argc, argv)
+ * @param   options The options to be created.
+ * @param   argc    The number of input arguments. Of type <tt>int</tt>
+ * @param   argv    The argument values. Of type <tt>char **</tt>.
+ *
+ * @return ParseResult PARSE_OK on success, otherwise PARSE_ERROR.
+ */
+inline ArgumentParser::ParseResult
+parseCommandLine(options & opt, int const argc, char* argv[])
+{
+    ArgumentParser parser("abdb_convert");
+
+    setShortDescription(parser, "Converts FASTA/FASTQ files into binary sequence databases (.abdb) or lane-interleaved SIMD layouts (.absl).");
+    setVersion(parser, SEQAN_APP_VERSION " [" SEQAN_REVISION "]");
+    setDate(parser, SEQAN_DATE);
+
+    addArgument(parser, ArgParseArgument(ArgParseArgument::INPUT_FILE, "IN_FILE"));
+    addArgument(parser, ArgParseArgument(ArgParseArgument::OUTPUT_FILE, "OUT_FILE"));
+
+    addOption(parser, seqan::ArgParseOption("a", "alphabet", "Alphabet the residues are stored in. dna and dna5 store Dna5, the nucleotide alphabet of the benchmarks, aa stores AminoAcid.", seqan::ArgParseArgument::STRING, "STRING"));
+    setValidValues(parser, "a", "dna dna5 aa");
+    setDefaultValue(parser, "a", "dna");
+
+    addOption(parser, seqan::ArgParseOption("", "reader-threads", "Number of threads parsing the input.", seqan::ArgParseArgument::INTEGER, "INT"));
+    setMinValue(parser, "reader-threads", "1");
+    setDefaultValue(parser, "reader-threads", std::to_string(defaultThreadCount()));
+
+    addOption(parser, seqan::ArgParseOption("w", "simd-width", "Write a lane-interleaved layout of 16 bit lanes for vectors of the given width in bits instead of a database.", seqan::ArgParseArgument::INTEGER, "INT"));
+    setValidValues(parser, "w", "128 256 512");
+
+    addOption(parser, seqan::ArgParseOption("", "binning", "Assignment of the sequences to the lanes of a layout.", seqan::ArgParseArgument::STRING, "STRING"));
+    setValidValues(parser, "binning", "input sorted");
+    setDefaultValue(parser, "binning", "input");
+
+    // Parse command line.
+    if (parse(parser, argc, argv) != ArgumentParser::PARSE_OK)
+        return ArgumentParser::PARSE_ERROR;
+
+    getArgumentValue(opt.in_file, parser, 0);
+    getArgumentValue(opt.out_file, parser, 1);
+
+    getOptionValue(opt.alphabet, parser, "a");
+    getOptionValue(opt.reader_threads, parser, "reader-threads");
+    getOptionValue(opt.simd_width, parser, "w");
+    getOptionValue(opt.binning, parser, "binning");
+
+    return ArgumentParser::PARSE_OK;
+}
+
+template <typename TAlphabet>
+inline int
+convert(options const & opt)
+{
+    StringSet<CharString> ids;
+    StringSet<String<TAlphabet>> seqs;
+
+    std::cout << "Reading " << opt.in_file << " ..." << std::flush;
+    if (!readSequences(ids, seqs, opt.in_file, opt.reader_threads))
+    {
+        std::cerr << "\nCould not read " << opt.in_file << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "\t done.\nWriting " << length(seqs) << " records to " << opt.out_file << " ..." << std::flush;
+    LengthBinning const binning = (opt.binning == "sorted") ? LengthBinning::SORTED : LengthBinning::INPUT;
+    bool const ok = (opt.simd_width != 0) ? writeSimdLayout<int16_t>(opt.out_file, seqs, opt.simd_width, binning)
+                                          : writeSequenceDatabase(opt.out_file, ids, seqs);
+    if (!ok)
+    {
+        std::cerr << "\nCould not write " << opt.out_file << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "\t done.\n";
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    options opt;
+
+    if (parseCommandLine(opt, argc, argv) != ArgumentParser::PARSE_OK)
+        return EXIT_FAILURE;
+
+    // The benchmarks read nucleotides as Dna5, which a database must be stored in to be aligned without a copy.
+    if (opt.alphabet == "aa")
+        return convert<AminoAcid>(opt);
+    return convert<Dna5>(opt);
+}
@@ -38,6 +38,7 @@
 #include <array>
 #include <future>
 #include <iostream>
+#include <vector>
 
 #include <seqan/seq_io.h>
 #include <seqan/stream.h>
@@ -45,6 +46,12 @@
 #include "align_bench_seqan.hpp"
 #include "sequence_generator.hpp"
 #include "align_bench_options.hpp"
+#include "scaling_report.hpp"
+#include "mapped_fasta.hpp"
+#include "sequence_database.hpp"
+#include "parallel_reader.hpp"
+#include "pair_space.hpp"
+#include "dataset_suite.hpp"
 
 using namespace seqan;
 
@@ -72,6 +79,19 @@ inline void invoke(AlignBenchOptions & options,
     std::cout << "\t\t\tdone." << std::endl;
     device.printProfile(std::cout);
     options.stats.time = device.getTime();
+    options.stats.runTimes = device.getRunTimes();
+    options.stats.warmupRuns = options.warmup;
+    options.stats.perfCounters = device.getPerfCounterValues();
+    options.stats.latency = device.getLatencyStats();
+    // The OpenMP loop over serial chunks replaced the policy, so the row must not pass for the policy itself.
+    if (device.isLatencyChunked())
+        options.stats.execPolicy += "_chunked";
+    options.stats.memory = device.getMemoryStats();
+    options.stats.energy = device.getEnergyStats();
+    // The GCUPS refer to the cells within the band, the padding of the engine is reported separately.
+    options.stats.totalCells = device.getCellCounts().useful;
+    options.stats.computedCells = device.getCellCounts().computed;
+    options.stats.phases += device.getPhases();
 }
 
 template <typename TScoreValue, typename... TArgs>
@@ -92,175 +112,389 @@ configureScore(AminoAcid const & /*tag*/,
     invoke(options, std::forward<TArgs>(args)..., Score<TScoreValue, ScoreMatrix<AminoAcid, ScoreSpecBlosum62> >(-1 , -11));
 }
 
-template <typename TAlphabet, typename ...TArgs>
+// ----------------------------------------------------------------------------
+// Class Workload
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class Workload
+ * @headerfile align_bench_configure.hpp
+ * @brief Sequences of a benchmark run and the pairwise alignment sets built as views over them.
+ *
+ * @signature template <typename TAlphabet, typename TStringSpec = Alloc<> >
+ *            struct Workload;
+ *
+ * With <tt>Packed<></tt> as string specialization the sequences are stored bit-packed, e.g. with 3 bits per
+ * <tt>Dna5</tt> and 5 bits per <tt>AminoAcid</tt>, and the alignments are computed on infixes of the packed strings,
+ * whose iterators unpack the residues on access.
+ *
+ * The views refer to the owning sets, hence a workload can neither be copied nor moved.
+ */
+template <typename TAlphabet, typename TStringSpec = Alloc<> >
+struct Workload
+{
+    using TString = String<TAlphabet, TStringSpec>;
+    using TView = typename Infix<TString const>::Type;
+
+    StringSet<TString> sequences1;
+    StringSet<TString> sequences2;
+
+    // Used instead of the owning sets if the input is memory-mapped.
+    MappedFasta<TAlphabet> mapped1;
+    MappedFasta<TAlphabet> mapped2;
+
+    // Used instead of the owning sets if the input is a binary sequence database.
+    SequenceDatabase<TAlphabet> database1;
+    SequenceDatabase<TAlphabet> database2;
+
+    // Views of all records, which the pairs refer to.
+    StringSet<TView> records1;
+    StringSet<TView> records2;
+
+    // The horizontal and vertical sequences of the alignments, looked up on demand.
+    LazyPairSet<TView> seqSet1;
+    LazyPairSet<TView> seqSet2;
+
+    // Time spent reading the sequences and building the pairs.
+    PhaseProfile phases;
+
+    Workload() = default;
+    Workload(Workload const &) = delete;
+    Workload & operator=(Workload const &) = delete;
+};
+
+// ----------------------------------------------------------------------------
+// Function appendMappedRecords()
+// ----------------------------------------------------------------------------
+
+// Appends the records of a mapped file in the given order to records. If the workload stores its sequences in
+// another string type, e.g. packed, the records are copied into sequences and the mapped file is closed.
+template <typename TSequences, typename TView, typename TMapped, typename TOrder>
 inline void
-configureSequences(AlignBenchOptions & options,
-                   TArgs && ...args)
+appendMappedRecords(TSequences & sequences, StringSet<TView> & records, TMapped & mapped, TOrder && order)
+{
+    resize(sequences, mapped.size(), Exact());
+    for (size_t i = 0; i < mapped.size(); ++i)
+        assign(sequences[i], mapped[order(i)], Exact());
+    mapped.close();
+
+    reserve(records, length(sequences), Exact());
+    for (size_t i = 0; i < length(sequences); ++i)
+        appendValue(records, infix(sequences[i], 0, length(sequences[i])));
+}
+
+// The views refer to the host of the mapped file.
+template <typename TAlphabet, typename TMapped, typename TOrder>
+inline void
+appendMappedRecords(StringSet<String<TAlphabet>> & /*sequences*/,
+                    StringSet<Segment<String<TAlphabet> const, InfixSegment>> & records,
+                    TMapped & mapped,
+                    TOrder && order)
 {
-    // If option for generating is specified.
-    using TView = typename Infix<String<TAlphabet> const>::Type;
-    StringSet<TView> seqSet1;
-    StringSet<TView> seqSet2;
+    reserve(records, mapped.size(), Exact());
+    for (size_t i = 0; i < mapped.size(); ++i)
+        appendValue(records, mapped[order(i)]);
+}
+
+// ----------------------------------------------------------------------------
+// Function readSequenceFile()
+// ----------------------------------------------------------------------------
+
+// Reads all records of a file into sequences using options.readerThreads threads, decompressing gzip files, or maps it if options.mmapInput is set, and appends views of the
+// records to records. Binary sequence databases are always mapped and their records are appended in the stored
+// length order if options.sortSequences is set. Returns false if the file could not be read.
+template <typename TAlphabet, typename TStringSpec, typename TView>
+inline bool
+readSequenceFile(AlignBenchOptions & options,
+                 std::string const & fileName,
+                 StringSet<String<TAlphabet, TStringSpec>> & sequences,
+                 MappedFasta<TAlphabet> & mapped,
+                 SequenceDatabase<TAlphabet> & database,
+                 StringSet<TView> & records)
+{
+    if (isSequenceDatabaseFile(fileName))
+    {
+        if (!database.open(fileName))
+            return false;
+
+        bool const sorted = options.sortSequences;
+        appendMappedRecords(sequences, records, database, [&](size_t const i)
+        {
+            return (sorted) ? database.sortedIndex(i) : i;
+        });
+        return true;
+    }
+
+    // Compressed files cannot be mapped and are always decompressed into memory.
+    if (options.mmapInput && !isGzipFile(fileName))
+    {
+        if (!mapped.open(fileName))
+            return false;
+
+        appendMappedRecords(sequences, records, mapped, [](size_t const i) { return i; });
+        return true;
+    }
+
+    StringSet<CharString> meta;
+    if (!readSequences(meta, sequences, fileName, options.readerThreads, &options.stats.decompression))
+        return false;
+
+    reserve(records, length(sequences), Exact());
+    for (size_t i = 0; i < length(sequences); ++i)
+        appendValue(records, infix(sequences[i], 0, length(sequences[i])));
+    return true;
+}
 
-    StringSet<String<TAlphabet>> tmp1;
-    StringSet<String<TAlphabet>> tmp2;
+// ----------------------------------------------------------------------------
+// Function loadWorkload()
+// ----------------------------------------------------------------------------
+
+// Generates or reads the sequences and builds the alignment sets. Returns false if the input could not be read.
+template <typename TAlphabet, typename TStringSpec>
+inline bool
+loadWorkload(AlignBenchOptions & options, Workload<TAlphabet, TStringSpec> & workload)
+{
+    auto & tmp1 = workload.sequences1;
+    auto & tmp2 = workload.sequences2;
+    auto & records1 = workload.records1;
+    auto & records2 = workload.records2;
+    using TView = typename Workload<TAlphabet, TStringSpec>::TView;
+
+    auto & phases = workload.phases;
 
     options.stats.totalCells = 0;
+    options.stats.decompression = DecompressionStats{};
     if (options.numSequences != -1)
     {
         std::cout << "Generate sequences ...";
-        SequenceGenerator<Dna> gen;
+        // Building the pairs is nested in the read phase, but only accounted to itself.
+        ScopedPhase readPhase(phases, Phase::READ);
+        SequenceGenerator<TAlphabet, TStringSpec> gen;
         gen.setNumber(options.numSequences);
         gen.setDistribution(options.distFunction);
         gen.setMinLength(options.minSize);
         gen.setMaxLength(options.maxSize);
+        gen.setLengthModel(options.lengths);
+        if (options.distFunction == DistributionFunction::EMPIRICAL_DISTRIBUTION)
+        {
+            std::vector<LengthBin> bins;
+            if (!readLengthHistogram(bins, options.lengths.histogramFile))
+            {
+                std::cerr << "\nCould not read length histogram " << options.lengths.histogramFile << std::endl;
+                return false;
+            }
+            gen.setLengthHistogram(bins);
+        }
+        gen.setSeed(options.seed);
+        gen.setThreads(options.readerThreads);
+        gen.setMutationModel(options.mutation);
 
-
-        tmp1 = gen.generate();
-        tmp2 = gen.generate();
+        // Derived databases form related pairs at the configured divergence, otherwise both sets are independent.
+        // With families both sets are derived from the family roots, such that every pair is formed by two
+        // independently mutated members of the same family.
+        if (options.families > 0 && options.mutation.enabled)
+        {
+            auto const members = gen.generateFamilies(options.families);
+            tmp1 = gen.mutate(members);
+            tmp2 = gen.mutate(members);
+        }
+        else
+        {
+            tmp1 = gen.generate();
+            tmp2 = (options.mutation.enabled) ? gen.mutate(tmp1) : gen.generate();
+        }
 
         options.stats.numSequences = options.numSequences;
         options.stats.seqMinLength = options.minSize;
         options.stats.seqMaxLength = options.maxSize;
-        options.stats.dist         = (options.distFunction == DistributionFunction::NORMAL_DISTRIBUTION) ? "normal" : "uniform";
+        options.stats.dist         = distributionName(options.distFunction);
 
+        phases.begin(Phase::PAIRS);
         for (unsigned i = 0; i < length(tmp1); ++i)
         {
-            appendValue(seqSet1, infix(tmp1[i], 0, length(tmp1[i])));
-            appendValue(seqSet2, infix(tmp2[i], 0, length(tmp2[i])));
-            options.stats.totalCells += (1+length(tmp1[i]))*(1+length(tmp2[i]));
+            appendValue(records1, infix(tmp1[i], 0, length(tmp1[i])));
+            appendValue(records2, infix(tmp2[i], 0, length(tmp2[i])));
         }
+        PairSpace const space(AlignmentMode::PAIR, length(records1), length(records2));
+        workload.seqSet1 = LazyPairSet<TView>(records1, space, false);
+        workload.seqSet2 = LazyPairSet<TView>(records2, space, true);
+        options.stats.totalCells = pairSpaceCells(space, records1, records2);
+        phases.end();
 
-       SeqFileOut ref_out("ref_seq.fa");
-       for (unsigned i = 0; i < length(tmp1); ++i)
-           writeRecord(ref_out, "seq1", tmp1[i]);
+        if (options.writeSimulated)
+        {
+            SeqFileOut ref_out("ref_seq.fa");
+            for (unsigned i = 0; i < length(tmp1); ++i)
+                writeRecord(ref_out, "seq1", tmp1[i]);
 
-           SeqFileOut qry_out("qry_seq.fa");
-           for (unsigned i = 0; i < length(tmp2); ++i)
-               writeRecord(qry_out, "seq2", tmp2[i]);
+            SeqFileOut qry_out("qry_seq.fa");
+            for (unsigned i = 0; i < length(tmp2); ++i)
+                writeRecord(qry_out, "seq2", tmp2[i]);
+        }
     } else
     {
+        // Cached data sets are only used if they are unchanged, which keeps the results of every machine comparable.
+        if (!options.dataset.empty())
+        {
+            BenchmarkDataset const * dataset = findBenchmarkDataset(options.dataset);
+            std::string error = "Unknown data set " + options.dataset + ".";
+            if (dataset == nullptr || !verifyDataset(error, options.datasetDir, *dataset))
+            {
+                std::cerr << error << "\nBuild it with: align_bench_datasets --dataset-dir " << options.datasetDir
+                          << " --dataset " << options.dataset << std::endl;
+                return false;
+            }
+        }
+
         std::cout << "Reading sequences ..." << std::flush;
-        StringSet<CharString> meta1;
-        StringSet<CharString> meta2;
+        ScopedPhase readPhase(phases, Phase::READ);
 
-        try {
-            SeqFileIn queryFile{options.queryFile.c_str()};
-            readRecords(meta1, tmp1, queryFile);
-        } catch(seqan::ParseError & e)
+        if (!readSequenceFile(options, options.queryFile, tmp1, workload.mapped1, workload.database1, records1))
         {
             std::cerr << "Could not read query file" << std::endl;
-            std::cerr << e.what() << std::endl;
-            return;
+            return false;
         }
 
-//        SeqFileOut fa_out("sd_0001.fa");
-//        for (unsigned i = 0; i < 1000; ++i)
-//            writeRecord(fa_out, meta1[i], tmp1[i]);
-
-        try {
-            SeqFileIn dbFile{options.databaseFile.c_str()};
-            readRecords(meta2, tmp2, dbFile);
-        } catch(ParseError & e)
-        {
-            std::cerr << e.what() << std::endl;
-            return;
-        } catch(...)
+        if (!readSequenceFile(options, options.databaseFile, tmp2, workload.mapped2, workload.database2, records2))
         {
             std::cerr << "Database: " << options.databaseFile << "\n";
             std::cerr << "Could not read database file" << std::endl;
-            return;
+            return false;
         }
 
+        ScopedPhase pairsPhase(phases, Phase::PAIRS);
         options.stats.sortSequences = "no";
         if (options.sortSequences)
         {
             options.stats.sortSequences = "yes";
             std::cout << "\t done.\nSorting Sequences ...";
 
-            std::sort(begin(tmp1, Standard()), end(tmp1, Standard()), [](auto const & s1, auto const & s2){ return length(s1) < length(s2); });
-            std::sort(begin(tmp2, Standard()), end(tmp2, Standard()), [](auto const & s1, auto const & s2){ return length(s1) < length(s2); });
+            // Only the views are sorted, the sequences stay in place. Databases are read in sorted order already.
+            if (!workload.database1.isOpen())
+                std::sort(begin(records1, Standard()), end(records1, Standard()), [](auto const & s1, auto const & s2){ return length(s1) < length(s2); });
+            if (!workload.database2.isOpen())
+                std::sort(begin(records2, Standard()), end(records2, Standard()), [](auto const & s1, auto const & s2){ return length(s1) < length(s2); });
         }
 
+        // The pairs are not materialized, but computed from their index when they are aligned.
         std::cout << "\t done.\nGenerating Sequences ..." << std::flush;
         switch (options.mode)
         {
             case AlignmentMode::PAIR:
-            {
                 options.stats.mode = "pair";
-                SEQAN_ASSERT_EQ(length(tmp1), length(tmp2));
-
-                for (unsigned i = 0; i < _min(length(tmp1), length(tmp2)); ++i)
-                {
-                    appendValue(seqSet1, infix(tmp1[i], 0, length(tmp1[i])), Generous());
-                    appendValue(seqSet2, infix(tmp2[i], 0, length(tmp2[i])), Generous());
-                    options.stats.totalCells += (1+length(tmp1[i]))*(1+length(tmp2[i]));
-                }
+                SEQAN_ASSERT_EQ(length(records1), length(records2));
                 break;
-            }
             case AlignmentMode::SEARCH:
-            {
                 options.stats.mode = "search";
-                for (unsigned i = 0; i < length(tmp1); ++i)
-                {
-                    for (unsigned j = 0; j < length(tmp2); ++j)
-                    {
-                        appendValue(seqSet1, infix(tmp1[i], 0, length(tmp1[i])), Generous());
-                        appendValue(seqSet2, infix(tmp2[j], 0, length(tmp2[j])), Generous());
-                        options.stats.totalCells += (1+length(tmp1[i]))*(1+length(tmp2[j]));
-                    }
-                }
                 break;
-            }
             case AlignmentMode::OLC:
-            {
                 options.stats.mode = "olc";
-                for (unsigned i = 0; i < length(tmp1); ++i)
-                {
-                    for (unsigned j = i+1; j < length(tmp1); ++j)
-                    {
-                        appendValue(seqSet1, infix(tmp1[i], 0, length(tmp1[i])), Generous());
-                        appendValue(seqSet2, infix(tmp1[j], 0, length(tmp2[j])), Generous());
-                        options.stats.totalCells += (1+length(tmp1[i]))*(1+length(tmp1[j]));
-                    }
-                }
                 break;
-            }
             default:
-                return;
+                return false;
         }
-        options.stats.seqMinLength = length(tmp1);
-        options.stats.seqMaxLength = length(tmp2);
-        options.stats.numSequences = length(seqSet1);
+        // The OLC mode aligns the query records with each other.
+        auto const & recordsV = (options.mode == AlignmentMode::OLC) ? records1 : records2;
+        PairSpace const space(options.mode, length(records1), length(recordsV));
+        workload.seqSet1 = LazyPairSet<TView>(records1, space, false);
+        workload.seqSet2 = LazyPairSet<TView>(recordsV, space, true);
+        options.stats.totalCells = pairSpaceCells(space, records1, recordsV);
+
+        options.stats.seqMinLength = length(records1);
+        options.stats.seqMaxLength = length(records2);
+        options.stats.numSequences = length(workload.seqSet1);
     }
-    options.stats.numAlignments = length(seqSet1);
+    options.stats.numAlignments = length(workload.seqSet1);
 
     std::cout << "\t done.\n";
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// Function isIntegerWidthAvailable()
+// ----------------------------------------------------------------------------
+
+// Returns true if configureScoreWidth() runs the alignments with scores of the given width in bits.
+inline bool
+isIntegerWidthAvailable(std::string const & bitWidth)
+{
+    return bitWidth == "16" || bitWidth == "32";
+}
+
+// ----------------------------------------------------------------------------
+// Function configureScoreWidth()
+// ----------------------------------------------------------------------------
+
+template <typename TAlphabet, typename TStringSpec, typename ...TArgs>
+inline void
+configureScoreWidth(AlignBenchOptions & options,
+                    Workload<TAlphabet, TStringSpec> & workload,
+                    TArgs && ...args)
+{
+    // The alignment run adds its phases to the ones of the workload.
+    options.stats.phases = workload.phases;
 
     switch(options.simdWidth)
     {
         case SimdIntegerWidth::BIT_8:
             options.stats.scoreValue = "int8_t";
-            // configureScore<int8_t>(TAlphabet(), options, std::forward<TArgs>(args)..., seqSet1, seqSet2);
+            // configureScore<int8_t>(TAlphabet(), options, std::forward<TArgs>(args)..., workload.seqSet1, workload.seqSet2);
         case SimdIntegerWidth::BIT_16:
             options.stats.scoreValue = "int16_t";
-            configureScore<int16_t>(TAlphabet(), options, std::forward<TArgs>(args)..., seqSet1, seqSet2);
+            configureScore<int16_t>(TAlphabet(), options, std::forward<TArgs>(args)..., workload.seqSet1, workload.seqSet2);
             break;
         case SimdIntegerWidth::BIT_32:
             options.stats.scoreValue = "int32_t";
-            configureScore<int32_t>(TAlphabet(), options, std::forward<TArgs>(args)..., seqSet1, seqSet2);
+            configureScore<int32_t>(TAlphabet(), options, std::forward<TArgs>(args)..., workload.seqSet1, workload.seqSet2);
             break;
         case SimdIntegerWidth::BIT_64:
             options.stats.scoreValue = "int64_t";
-            //configureScore<int64_t>(TAlphabet(), options, std::forward<TArgs>(args)..., seqSet1, seqSet2);
+            //configureScore<int64_t>(TAlphabet(), options, std::forward<TArgs>(args)..., workload.seqSet1, workload.seqSet2);
             break;
     }
 }
 
+// ----------------------------------------------------------------------------
+// Function configureSequences()
+// ----------------------------------------------------------------------------
+
+template <typename TAlphabet, typename TStringSpec, typename ...TArgs>
+inline void
+configureSequences(AlignBenchOptions & options,
+                   TArgs && ...args)
+{
+    Workload<TAlphabet, TStringSpec> workload;
+    if (!loadWorkload(options, workload))
+        return;
+
+    configureScoreWidth(options, workload, std::forward<TArgs>(args)...);
+}
+
+template <typename TAlphabet, typename ...TArgs>
+inline void
+configureSequences(AlignBenchOptions & options,
+                   TArgs && ...args)
+{
+    if (options.packed)
+    {
+        options.stats.storage = "packed";
+        configureSequences<TAlphabet, Packed<>>(options, std::forward<TArgs>(args)...);
+    }
+    else
+    {
+        options.stats.storage = "plain";
+        configureSequences<TAlphabet, Alloc<>>(options, std::forward<TArgs>(args)...);
+    }
+}
+
 template <typename ...TArgs>
 inline void
 configureAlpha(AlignBenchOptions & options, TArgs && ...args)
 {
+    // The counters only follow threads that are spawned after they were opened.
+    if (options.hwCounters)
+        processPerfCounters();
+
     if (options.alpha == ScoreAlphabet::DNA)
     {
         options.stats.scoreAlpha = "dna";
@@ -273,4 +507,106 @@ configureAlpha(AlignBenchOptions & options, TArgs && ...args)
     }
 }
 
+// ----------------------------------------------------------------------------
+// Function configureScaling()
+// ----------------------------------------------------------------------------
+
+/*!
+ * @fn configureScaling
+ * @brief Runs the workload with 1, 2, 4, ... <tt>options.threadCount</tt> threads and writes a scaling report.
+ *
+ * For strong scaling the workload is loaded once and stays fixed. For weak scaling it grows linearly with the
+ * number of threads: simulated data sets are generated with <tt>p</tt> times the number of sequences, read data
+ * sets are replicated <tt>p</tt> times. One stats row is written per run, followed by the report.
+ */
+template <typename TAlphabet, typename TStringSpec, typename TRunner, typename TStream>
+inline void
+configureScaling(AlignBenchOptions & options, TRunner && runner, TStream & stream)
+{
+    bool isWeak = options.scaling == ScalingMode::WEAK;
+    bool isSimulated = options.numSequences != -1;
+    ScalingReport report(isWeak ? "weak" : "strong", options.stats.execPolicy);
+
+    Workload<TAlphabet, TStringSpec> baseWorkload;
+    if (!(isWeak && isSimulated) && !loadWorkload(options, baseWorkload))
+        return;
+
+    std::vector<AlignBenchStats> runStats;
+    for (unsigned threads : scalingThreadCounts(options.threadCount))
+    {
+        AlignBenchOptions runOptions = options;
+        runOptions.threadCount = threads;
+        runOptions.stats.threads = threads;
+
+        Workload<TAlphabet, TStringSpec> scaledWorkload;
+        if (isWeak && isSimulated)
+        {
+            runOptions.numSequences = options.numSequences * threads;
+            if (!loadWorkload(runOptions, scaledWorkload))
+                return;
+            runner(runOptions, scaledWorkload);
+        }
+        else if (isWeak)
+        {
+            // The replicated pairs refer to the records of the base workload.
+            scaledWorkload.seqSet1 = baseWorkload.seqSet1.replicated(threads);
+            scaledWorkload.seqSet2 = baseWorkload.seqSet2.replicated(threads);
+            scaledWorkload.phases = baseWorkload.phases;
+            runOptions.stats.totalCells = options.stats.totalCells * threads;
+            runOptions.stats.numAlignments = options.stats.numAlignments * threads;
+            runner(runOptions, scaledWorkload);
+        }
+        else
+        {
+            runner(runOptions, baseWorkload);
+        }
+
+        runOptions.stats.state = "done";
+        runStats.push_back(runOptions.stats);
+        report.add(ScalingPoint{threads, runOptions.stats.time, runOptions.stats.totalCells});
+    }
+
+    // Written after all runs, so that the progress output of the runs does not interleave with the table.
+    options.stats.writeHeader(stream);
+    for (auto & stats : runStats)
+        stats.writeStats(stream);
+    stream << "\n";
+    report.write(stream);
+}
+
+template <typename TAlphabet, typename TRunner, typename TStream>
+inline void
+configureScaling(AlignBenchOptions & options, TRunner && runner, TStream & stream)
+{
+    if (options.packed)
+    {
+        options.stats.storage = "packed";
+        configureScaling<TAlphabet, Packed<>>(options, std::forward<TRunner>(runner), stream);
+    }
+    else
+    {
+        options.stats.storage = "plain";
+        configureScaling<TAlphabet, Alloc<>>(options, std::forward<TRunner>(runner), stream);
+    }
+}
+
+template <typename TRunner, typename TStream>
+inline void
+configureScaling(AlignBenchOptions & options, TRunner && runner, TStream & stream)
+{
+    if (options.hwCounters)
+        processPerfCounters();
+
+    if (options.alpha == ScoreAlphabet::DNA)
+    {
+        options.stats.scoreAlpha = "dna";
+        configureScaling<Dna5>(options, std::forward<TRunner>(runner), stream);
+    }
+    else
+    {
+        options.stats.scoreAlpha = "aa";
+        configureScaling<AminoAcid>(options, std::forward<TRunner>(runner), stream);
+    }
+}
+
 #endif  // ALIGN_BENCH_CONFIGURE_HPP
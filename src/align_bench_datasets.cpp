@@ -0,0 +1,207 @@
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include <seqan/basic.h>
+#include <seqan/arg_parse.h>
+#include <seqan/sequence.h>
+
+#include "align_bench_options.hpp"
+#include "dataset_suite.hpp"
+#include "sequence_database.hpp"
+#include "sequence_generator.hpp"
+
+using namespace seqan;
+
+struct options
+{
+    std::string                 dataset_dir;
+    std::vector<std::string>    datasets;
+    unsigned                    threads;
+    bool                        list{false};
+    bool                        verify{false};
+    bool                        force{false};
+};
+
+/*
+ * @fn parsCommandLine
+ *
+ * @brief Parses the command line arguments and options.
+ *
+ * @signature ParseResult parseCommandLine(options, argc, argv)
+ * @param   options The options to be created.
+ * @param   argc    The number of input arguments. Of type <tt>int</tt>
+ * @param   argv    The argument values. Of type <tt>char **</tt>.
+ *
+ * @return ParseResult PARSE_OK on success, otherwise PARSE_ERROR.
+ */
+inline ArgumentParser::ParseResult
+parseCommandLine(options & opt, int const argc, char* argv[])
+{
+    ArgumentParser parser("align_bench_datasets");
+
+    setShortDescription(parser, "Builds the data sets of the benchmark suite as checksummed binary sequence databases.");
+    setVersion(parser, SEQAN_APP_VERSION " [" SEQAN_REVISION "]");
+    setDate(parser, SEQAN_DATE);
+
+    addOption(parser, seqan::ArgParseOption("", "dataset-dir", "Directory of the cached data sets. Defaults to $ALIGN_BENCH_DATASETS or datasets.", seqan::ArgParseArgument::STRING, "DIR"));
+    setDefaultValue(parser, "dataset-dir", defaultDatasetDir());
+
+    addOption(parser, seqan::ArgParseOption("", "dataset", "Data set to build. Can be given multiple times, all data sets of the suite are built by default.", seqan::ArgParseArgument::STRING, "NAME", true));
+    setValidValues(parser, "dataset", datasetNames());
+
+    addOption(parser, seqan::ArgParseOption("t", "threads", "Number of threads simulating the sequences. The data sets do not depend on it.", seqan::ArgParseArgument::INTEGER, "INT"));
+    setMinValue(parser, "t", "1");
+    setDefaultValue(parser, "t", std::to_string(defaultThreadCount()));
+
+    addOption(parser, seqan::ArgParseOption("", "list", "Lists the data sets of the suite."));
+    addOption(parser, seqan::ArgParseOption("", "verify", "Verifies the checksums of the cached data sets instead of building them."));
+    addOption(parser, seqan::ArgParseOption("", "force", "Rebuilds data sets that are cached already."));
+
+    // Parse command line.
+    if (parse(parser, argc, argv) != ArgumentParser::PARSE_OK)
+        return ArgumentParser::PARSE_ERROR;
+
+    getOptionValue(opt.dataset_dir, parser, "dataset-dir");
+    for (unsigned i = 0; i < getOptionValueCount(parser, "dataset"); ++i)
+    {
+        std::string name;
+        getOptionValue(name, parser, "dataset", i);
+        opt.datasets.push_back(name);
+    }
+    getOptionValue(opt.threads, parser, "t");
+    opt.list = isSet(parser, "list");
+    opt.verify = isSet(parser, "verify");
+    opt.force = isSet(parser, "force");
+
+    return ArgumentParser::PARSE_OK;
+}
+
+template <typename TGenerator>
+inline void
+setLengths(TGenerator & gen, BenchmarkDataset const & dataset)
+{
+    LengthModel lengths;
+    lengths.mean = dataset.mean;
+    lengths.sd = dataset.sd;
+    gen.setNumber(dataset.numSequences);
+    gen.setDistribution(dataset.distFunction);
+    gen.setMinLength(dataset.minSize);
+    gen.setMaxLength(dataset.maxSize);
+    gen.setLengthModel(lengths);
+}
+
+template <typename TSeqs>
+inline bool
+writeRecords(std::string const & fileName, std::string const & prefix, TSeqs const & seqs)
+{
+    StringSet<CharString> ids;
+    reserve(ids, length(seqs), Exact());
+    for (size_t i = 0; i < length(seqs); ++i)
+        appendValue(ids, prefix + std::to_string(i));
+    return writeSequenceDatabase(fileName, ids, seqs);
+}
+
+// Simulates the data set from its pinned parameters. The order of the generated sets is part of the data set, since
+// every set draws from the next random streams of the generator.
+template <typename TAlphabet>
+inline bool
+build(BenchmarkDataset const & dataset, options const & opt)
+{
+    SequenceGenerator<TAlphabet> gen;
+    gen.setSeed(dataset.seed);
+    gen.setThreads(opt.threads);
+    MutationModel mutation;
+    if (dataset.identity >= 0.0)
+        setMutationIdentity(mutation, dataset.identity);
+    gen.setMutationModel(mutation);
+
+    StringSet<String<TAlphabet>> queries;
+    StringSet<String<TAlphabet>> database;
+    if (dataset.genomeLength > 0)
+    {
+        gen.setNumber(1);
+        gen.setMinLength(dataset.genomeLength);
+        gen.setMaxLength(dataset.genomeLength);
+        auto const genome = gen.generate();
+        setLengths(gen, dataset);
+        queries = gen.sample(genome[0]);
+        if (mutation.enabled)
+            queries = gen.mutate(queries);
+    }
+    else if (dataset.families > 0)
+    {
+        setLengths(gen, dataset);
+        auto const members = gen.generateFamilies(dataset.families);
+        queries = gen.mutate(members);
+        database = gen.mutate(members);
+    }
+    else
+    {
+        setLengths(gen, dataset);
+        queries = gen.generate();
+        database = (mutation.enabled) ? gen.mutate(queries) : gen.generate();
+    }
+
+    // The checksums are written last, so that an interrupted build is never taken for a cached data set.
+    std::remove(datasetChecksumFile(opt.dataset_dir, dataset).c_str());
+    if (!writeRecords(datasetQueryFile(opt.dataset_dir, dataset), "q", queries))
+        return false;
+    if (dataset.mode != AlignmentMode::OLC &&
+        !writeRecords(datasetDatabaseFile(opt.dataset_dir, dataset), "d", database))
+        return false;
+    return writeDatasetChecksums(opt.dataset_dir, dataset);
+}
+
+int main(int argc, char* argv[])
+{
+    options opt;
+
+    if (parseCommandLine(opt, argc, argv) != ArgumentParser::PARSE_OK)
+        return EXIT_FAILURE;
+
+    if (opt.list)
+    {
+        for (auto const & dataset : benchmarkDatasets())
+            std::cout << dataset.name << ".v" << DATASET_SUITE_VERSION << "\t" << dataset.description << "\n";
+        return EXIT_SUCCESS;
+    }
+
+    if (opt.datasets.empty())
+        for (auto const & dataset : benchmarkDatasets())
+            opt.datasets.push_back(dataset.name);
+
+    if (!opt.verify)
+        mkdir(opt.dataset_dir.c_str(), 0755);
+
+    int result = EXIT_SUCCESS;
+    for (auto const & name : opt.datasets)
+    {
+        BenchmarkDataset const & dataset = *findBenchmarkDataset(name);
+        std::string error;
+        bool const cached = verifyDataset(error, opt.dataset_dir, dataset);
+        if (opt.verify || (cached && !opt.force))
+        {
+            std::cout << name << ":\t" << (cached ? "ok" : error) << "\n";
+            if (!cached)
+                result = EXIT_FAILURE;
+            continue;
+        }
+
+        std::cout << "Building " << name << " ..." << std::flush;
+        bool const ok = (dataset.alpha == ScoreAlphabet::DNA) ? build<Dna5>(dataset, opt)
+                                                              : build<AminoAcid>(dataset, opt);
+        if (!ok)
+        {
+            std::cerr << "\nCould not write " << name << " to " << opt.dataset_dir << std::endl;
+            result = EXIT_FAILURE;
+            continue;
+        }
+        std::cout << "\t done.\n";
+    }
+    return result;
+}
@@ -35,14 +35,84 @@
 #ifndef ALIGN_BENCH_OPTIONS_H_
 #define ALIGN_BENCH_OPTIONS_H_
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <string>
+#include <thread>
+#include <vector>
+
+#include "run_statistics.hpp"
+#include "perf_counters.hpp"
+#include "latency_histogram.hpp"
+#include "memory_stats.hpp"
+#include "phase_timer.hpp"
+#include "rapl_energy.hpp"
+#include "decompression.hpp"
 
 enum class DistributionFunction : uint8_t
 {
     UNIFORM_DISTRIBUTION,
     NORMAL_DISTRIBUTION,
+    LOGNORMAL_DISTRIBUTION,
+    GAMMA_DISTRIBUTION,
+    PARETO_DISTRIBUTION,
+    EMPIRICAL_DISTRIBUTION
+};
+
+inline std::string distributionName(DistributionFunction const dist)
+{
+    switch (dist)
+    {
+        case DistributionFunction::NORMAL_DISTRIBUTION: return "normal";
+        case DistributionFunction::LOGNORMAL_DISTRIBUTION: return "lognormal";
+        case DistributionFunction::GAMMA_DISTRIBUTION: return "gamma";
+        case DistributionFunction::PARETO_DISTRIBUTION: return "pareto";
+        case DistributionFunction::EMPIRICAL_DISTRIBUTION: return "empirical";
+        default: return "uniform";
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Class LengthModel
+// ----------------------------------------------------------------------------
+
+// Parameters of the simulated length distribution within [minSize, maxSize]. A non-positive mean defaults to the
+// center of the range, a negative standard deviation to a sixth of the range. The shape is the tail index of the
+// Pareto distribution, which otherwise follows from the mean.
+struct LengthModel
+{
+    double      mean{0.0};
+    double      sd{-1.0};
+    double      shape{0.0};
+    std::string histogramFile;
 };
 
+// ----------------------------------------------------------------------------
+// Class MutationModel
+// ----------------------------------------------------------------------------
+
+// Per-residue event rates applied to derive the simulated database sequences from the query sequences.
+// Indel lengths are geometrically distributed with mean meanIndelLength.
+struct MutationModel
+{
+    bool   enabled{false};
+    double substitutionRate{0.0};
+    double insertionRate{0.0};
+    double deletionRate{0.0};
+    double meanIndelLength{1.0};
+};
+
+// Splits the divergence 1 - identity into 80% substitutions and 10% insertions and deletions each.
+inline void setMutationIdentity(MutationModel & model, double const identity)
+{
+    double const divergence = std::min(std::max(1.0 - identity, 0.0), 1.0);
+    model.enabled = true;
+    model.substitutionRate = 0.8 * divergence;
+    model.insertionRate = 0.1 * divergence / std::max(model.meanIndelLength, 1.0);
+    model.deletionRate = 0.1 * divergence / std::max(model.meanIndelLength, 1.0);
+}
+
 enum class AlignMethod : uint8_t
 {
     GLOBAL,
@@ -74,6 +144,13 @@ enum class ScoreAlphabet : uint8_t
     AMINOACID
 };
 
+enum class ScalingMode : uint8_t
+{
+    NONE,
+    STRONG,
+    WEAK
+};
+
 enum class AlignmentMode : uint8_t
 {
     PAIR,
@@ -81,6 +158,20 @@ enum class AlignmentMode : uint8_t
     OLC
 };
 
+enum class ScoreFormat : uint8_t
+{
+    TEXT,
+    BINARY
+};
+
+enum class AlignmentFormat : uint8_t
+{
+    GAPS,
+    CIGAR,
+    SAM,
+    PAF
+};
+
 struct AlignBenchStats
 {
     std::string             execPolicy;
@@ -88,17 +179,27 @@ struct AlignBenchStats
     int                     numSequences;
     size_t                  seqMinLength;
     size_t                  seqMaxLength;
-    unsigned                numAlignments;
+    uint64_t                numAlignments;
     double                  totalCells;
+    double                  computedCells{0};
     std::string             dist;
     std::string             mode;
     std::string             method;
     std::string             scoreValue;
     std::string             scoreAlpha;
     std::string             sortSequences;
+    std::string             storage{"plain"};
     std::string             isBanded;
     std::vector<int32_t>    scores;
     double                  time;
+    std::vector<double>     runTimes;
+    unsigned                warmupRuns{0};
+    PerfCounterValues       perfCounters;
+    LatencyStats            latency;
+    MemoryStats             memory;
+    PhaseProfile            phases;
+    EnergyStats             energy;
+    DecompressionStats      decompression;
 
     size_t                  blockSize{0};
     size_t                  threads{0};
@@ -115,8 +216,11 @@ struct AlignBenchStats
         // stream << "SeqMax,";
         stream << "#Alignments,";
         stream << "sorted,";
-        stream << "banded";
+        stream << "Storage,";
+        stream << "banded,";
         stream << "#GCells,";
+        stream << "#ComputedCells,";
+        stream << "CellEfficiency,";
         stream << "Dist,";
         stream << "BitsPerScore,";
         stream << "Alphabet,";
@@ -124,6 +228,40 @@ struct AlignBenchStats
         stream << "Method,";
         stream << "Time,";
         stream << "GCUPS,";
+        stream << "#Runs,";
+        stream << "#WarmUp,";
+        stream << "GCUPSMin,";
+        stream << "GCUPSMedian,";
+        stream << "GCUPSMean,";
+        stream << "GCUPSStdDev,";
+        stream << "GCUPSP95,";
+        stream << "Cycles,";
+        stream << "Instructions,";
+        stream << "IPC,";
+        stream << "InstrPerCell,";
+        stream << "L1DMisses,";
+        stream << "LLCMisses,";
+        stream << "BranchMisses,";
+        stream << "LatP50,";
+        stream << "LatP90,";
+        stream << "LatP99,";
+        stream << "LatP999,";
+        stream << "Makespan,";
+        stream << "StragglerTail,";
+        stream << "PeakRSS,";
+        stream << "Allocs,";
+        stream << "BytesPerCell,";
+        stream << "DecompMBps,";
+        stream << "PhaseRead,";
+        stream << "PhasePairs,";
+        stream << "PhaseDP,";
+        stream << "PhaseTraceback,";
+        stream << "PhaseOutput,";
+        stream << "EndToEnd,";
+        stream << "PkgJoules,";
+        stream << "DramJoules,";
+        stream << "AvgWatts,";
+        stream << "GCUPSPerWatt,";
         stream << "BlockSize,";
         stream << "#Threads,";
         stream << "#Instances,";
@@ -144,15 +282,110 @@ struct AlignBenchStats
                 //   seqMaxLength  << "," <<
                   numAlignments << "," <<
                   sortSequences << "," <<
+                  storage       << "," <<
                   isBanded      << "," <<
-                  totalCells    << "," <<
-                  dist          << "," <<
+                  totalCells    << ",";
+        // Share of the computed cells that lie within the band, below 1 due to SIMD or tile padding.
+        if (computedCells > 0)
+            stream << computedCells << "," << totalCells / computedCells << ",";
+        else
+            stream << "n/a,n/a,";
+        stream << dist          << "," <<
                   scoreValue    << "," <<
                   scoreAlpha    << "," <<
                   mode          << "," <<
                   method        << ",";
         stream << time << ",";
         stream << (static_cast<double>(totalCells) / time) / 1000000000.0 << ",";
+        RunStatistics runStats = computeRunStatistics(runTimes, totalCells);
+        stream << runTimes.size()   << "," <<
+                  warmupRuns        << "," <<
+                  runStats.min      << "," <<
+                  runStats.median   << "," <<
+                  runStats.mean     << "," <<
+                  runStats.stddev   << "," <<
+                  runStats.p95      << ",";
+
+        auto writeCounter = [&](PerfEvent const event)
+        {
+            if (perfCounters.isAvailable(event))
+                stream << perfCounters[event] << ",";
+            else
+                stream << "n/a,";
+        };
+        writeCounter(PerfEvent::CYCLES);
+        writeCounter(PerfEvent::INSTRUCTIONS);
+        if (perfCounters.isAvailable(PerfEvent::CYCLES) && perfCounters.isAvailable(PerfEvent::INSTRUCTIONS) &&
+            perfCounters[PerfEvent::CYCLES] > 0)
+            stream << perfCounters[PerfEvent::INSTRUCTIONS] / perfCounters[PerfEvent::CYCLES] << ",";
+        else
+            stream << "n/a,";
+        if (perfCounters.isAvailable(PerfEvent::INSTRUCTIONS) && totalCells > 0)
+            stream << perfCounters[PerfEvent::INSTRUCTIONS] / totalCells << ",";
+        else
+            stream << "n/a,";
+        writeCounter(PerfEvent::L1D_MISSES);
+        writeCounter(PerfEvent::LLC_MISSES);
+        writeCounter(PerfEvent::BRANCH_MISSES);
+        if (latency.enabled)
+        {
+            stream << latency.p50           << "," <<
+                      latency.p90           << "," <<
+                      latency.p99           << "," <<
+                      latency.p999          << "," <<
+                      latency.makespan      << "," <<
+                      latency.stragglerTail << ",";
+        }
+        else
+        {
+            stream << "n/a,n/a,n/a,n/a,n/a,n/a,";
+        }
+
+        // Without the interposed allocator the bytes per cell are derived from the growth of the RSS.
+        stream << memory.peakRss << ",";
+        if (memory.heapTracked)
+            stream << memory.allocs << ",";
+        else
+            stream << "n/a,";
+        if (totalCells > 0)
+            stream << static_cast<double>(memory.heapTracked ? memory.peakHeap : memory.rssGrowth) / totalCells << ",";
+        else
+            stream << "n/a,";
+        if (decompression.isAvailable())
+            stream << decompression.mbPerSecond() << ",";
+        else
+            stream << "n/a,";
+        auto writePhase = [&](Phase const phase)
+        {
+            if (phases.isMeasured(phase))
+                stream << phases[phase] << ",";
+            else
+                stream << "n/a,";
+        };
+        writePhase(Phase::READ);
+        writePhase(Phase::PAIRS);
+        writePhase(Phase::DP);
+        writePhase(Phase::TRACEBACK);
+        writePhase(Phase::OUTPUT);
+        stream << phases.total() << ",";
+        // The energy is the mean of the timed runs, as is the time.
+        if (energy.isAvailable())
+            stream << energy.packageJoules << ",";
+        else
+            stream << "n/a,";
+        if (energy.dramJoules >= 0.0)
+            stream << energy.dramJoules << ",";
+        else
+            stream << "n/a,";
+        if (energy.isAvailable() && time > 0 && energy.totalJoules() > 0)
+        {
+            double const watts = energy.totalJoules() / time;
+            stream << watts << "," << ((totalCells / time) / 1000000000.0) / watts << ",";
+        }
+        else
+        {
+            stream << "n/a,n/a,";
+        }
         if (blockSize != 0)
             stream << blockSize << ",";
         else
@@ -183,14 +416,29 @@ struct AlignBenchStats
     }
 };
 
+// Default number of pairs aligned per batch. A multiple of every vector length, so the batches fill whole vectors.
+constexpr size_t DEFAULT_PAIR_BATCH = 16384;
+
+// hardware_concurrency() may return 0 if the value is not computable, which must not end up as thread count.
+inline unsigned defaultThreadCount()
+{
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
 struct AlignBenchOptions
 {
     std::string queryFile;
     std::string databaseFile;
+    std::string dataset;
+    std::string datasetDir;
     std::string alignOut;
     unsigned rep{1};
-    unsigned threadCount;
-    unsigned parallelInstances;
+    unsigned warmup{0};
+    unsigned threadCount{1};
+    unsigned readerThreads{1};
+    size_t   pairBatch{DEFAULT_PAIR_BATCH};
+    size_t   streamBatch{0};
+    unsigned parallelInstances{1};
     unsigned blockSize;
     int      numSequences{0};
     int      lower;
@@ -202,14 +450,29 @@ struct AlignBenchOptions
     bool     blockOptimization{false};
     bool     isBanded{false};
     bool     traceEnabled{false};
-    AlignmentMode mode;
-    AlignMethod  method;
+    bool     splitTraceback{false};
+    bool     mmapInput{false};
+    bool     packed{false};
+    bool     writeSimulated{false};
+    bool     flushCache{false};
+    bool     hwCounters{false};
+    bool     latency{false};
+    bool     directIo{false};
+    AlignmentMode mode{AlignmentMode::PAIR};
+    ScoreFormat  scoreFormat{ScoreFormat::TEXT};
+    AlignmentFormat alignFormat{AlignmentFormat::GAPS};
+    AlignMethod  method{AlignMethod::GLOBAL};
     ParallelMode parMode = ParallelMode::SEQUENTIAL;
 
     SimdIntegerWidth simdWidth;
     ScoreAlphabet alpha;
 
     DistributionFunction distFunction{DistributionFunction::UNIFORM_DISTRIBUTION};
+    LengthModel lengths;
+    MutationModel mutation;
+    uint32_t seed{std::numeric_limits<uint32_t>::max()};
+    unsigned families{0};
+    ScalingMode scaling{ScalingMode::NONE};
 
     AlignBenchStats stats;
 };
@@ -42,7 +42,10 @@ parseCommandLine(AlignBenchOptions & options, int const argc, char* argv[])
     setup_parser(parser);
 
     addOption(parser, seqan::ArgParseOption("t", "threads", "Number of threads", seqan::ArgParseArgument::INTEGER, "INT"));
-    setDefaultValue(parser, "t", toString(std::thread::hardware_concurrency()));
+    setDefaultValue(parser, "t", toString(defaultThreadCount()));
+
+    addOption(parser, seqan::ArgParseOption("", "scaling", "Runs the workload with 1, 2, 4, ... up to the given number of threads and reports speedup, efficiency and Karp-Flatt metric. For weak scaling the workload grows with the number of threads.", seqan::ArgParseArgument::STRING, "STRING"));
+    setValidValues(parser, "scaling", "strong weak");
 
     // Parse command line.
     if (parse(parser, argc, argv) != ArgumentParser::PARSE_OK)
@@ -55,6 +58,12 @@ parseCommandLine(AlignBenchOptions & options, int const argc, char* argv[])
         return ArgumentParser::PARSE_ERROR;
 
     getOptionValue(options.threadCount, parser, "t");
+    if (options.threadCount == 0)
+        options.threadCount = defaultThreadCount();
+
+    std::string scaling;
+    if (getOptionValue(scaling, parser, "scaling"))
+        setScalingMode(options, scaling);
 
     return ArgumentParser::PARSE_OK;
 }
@@ -76,6 +85,16 @@ int main(int argc, char* argv[])
     {
         options.stats.execPolicy = "parallel_vec";
         options.stats.vectorLength = SEQAN_SIZEOF_MAX_VECTOR / static_cast<unsigned>(options.simdWidth);
+        if (options.scaling != ScalingMode::NONE)
+        {
+            configureScaling(options, [] (AlignBenchOptions & runOptions, auto & workload)
+            {
+                seqan::ExecutionPolicy<seqan::Parallel, seqan::Vectorial> exec_policy;
+                setNumThreads(exec_policy, runOptions.threadCount);
+                configureScoreWidth(runOptions, workload, exec_policy);
+            }, std::cout);
+            return EXIT_SUCCESS;
+        }
         seqan::ExecutionPolicy<seqan::Parallel, seqan::Vectorial> exec_policy;
         setNumThreads(exec_policy, options.threadCount);
         configureAlpha(options, exec_policy);
@@ -43,7 +43,7 @@ parseCommandLine(AlignBenchOptions & options, int const argc, char* argv[])
     setup_parser(parser);
 
     addOption(parser, seqan::ArgParseOption("t", "threads", "Number of threads", seqan::ArgParseArgument::INTEGER, "INT"));
-    setDefaultValue(parser, "t", toString(std::thread::hardware_concurrency()));
+    setDefaultValue(parser, "t", toString(defaultThreadCount()));
 
     // Parse command line.
     if (parse(parser, argc, argv) != ArgumentParser::PARSE_OK)
@@ -56,6 +56,8 @@ parseCommandLine(AlignBenchOptions & options, int const argc, char* argv[])
         return ArgumentParser::PARSE_ERROR;
 
     getOptionValue(options.threadCount, parser, "t");
+    if (options.threadCount == 0)
+        options.threadCount = defaultThreadCount();
 
     return ArgumentParser::PARSE_OK;
 }
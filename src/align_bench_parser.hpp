@@ -35,10 +35,14 @@
 #ifndef ALIGN_BENCH_PARSER_HPP_
 #define ALIGN_BENCH_PARSER_HPP_
 
+#include <algorithm>
+#include <thread>
+
 #include <seqan/arg_parse.h>
 #include <seqan/stream.h>
 
 #include "align_bench_options.hpp"
+#include "dataset_suite.hpp"
 
 using namespace seqan;
 
@@ -49,6 +53,124 @@ auto toString = [](auto elem)
     return tmp.str();
 };
 
+// ----------------------------------------------------------------------------
+// Functions converting option values.
+// ----------------------------------------------------------------------------
+
+template <typename TOptions>
+inline void setDistribution(TOptions & options, std::string const & pdf)
+{
+    if (pdf == "normal")
+        options.distFunction = DistributionFunction::NORMAL_DISTRIBUTION;
+    else if (pdf == "uniform")
+        options.distFunction = DistributionFunction::UNIFORM_DISTRIBUTION;
+    else if (pdf == "lognormal")
+        options.distFunction = DistributionFunction::LOGNORMAL_DISTRIBUTION;
+    else if (pdf == "gamma")
+        options.distFunction = DistributionFunction::GAMMA_DISTRIBUTION;
+    else if (pdf == "pareto")
+        options.distFunction = DistributionFunction::PARETO_DISTRIBUTION;
+    else if (pdf == "empirical")
+        options.distFunction = DistributionFunction::EMPIRICAL_DISTRIBUTION;
+}
+
+// Length profiles of common sequencing technologies and protein databases.
+template <typename TOptions>
+inline void setLengthPreset(TOptions & options, std::string const & preset)
+{
+    auto setLengths = [&] (DistributionFunction const dist, unsigned const minSize, unsigned const maxSize,
+                           double const mean, double const sd)
+    {
+        options.distFunction = dist;
+        options.minSize = minSize;
+        options.maxSize = maxSize;
+        options.lengths.mean = mean;
+        options.lengths.sd = sd;
+    };
+
+    if (preset == "illumina")
+        setLengths(DistributionFunction::NORMAL_DISTRIBUTION, 100, 151, 150, 1);
+    else if (preset == "hifi")
+        setLengths(DistributionFunction::LOGNORMAL_DISTRIBUTION, 5000, 35000, 15000, 4000);
+    else if (preset == "ont")
+        setLengths(DistributionFunction::LOGNORMAL_DISTRIBUTION, 200, 200000, 12000, 12000);
+    else if (preset == "uniprot")
+        setLengths(DistributionFunction::GAMMA_DISTRIBUTION, 20, 35000, 360, 300);
+}
+
+// Replaces the input files by the cached files of a data set of the suite, which also determines the alphabet and
+// the alignment mode. The Dist column names the data set and its suite version.
+template <typename TOptions>
+inline void setDataset(TOptions & options, BenchmarkDataset const & dataset, std::string const & dir)
+{
+    options.dataset = dataset.name;
+    options.datasetDir = dir;
+    options.queryFile = datasetQueryFile(dir, dataset);
+    options.databaseFile = datasetDatabaseFile(dir, dataset);
+    options.numSequences = -1;
+    options.alpha = dataset.alpha;
+    options.mode = dataset.mode;
+    options.stats.dist = dataset.name + ".v" + std::to_string(DATASET_SUITE_VERSION);
+}
+
+template <typename TOptions>
+inline void setIntegerWidth(TOptions & options, std::string const & bitWidth)
+{
+    if (bitWidth == "8")
+        options.simdWidth = SimdIntegerWidth::BIT_8;
+    else if (bitWidth == "16")
+        options.simdWidth = SimdIntegerWidth::BIT_16;
+    else if (bitWidth == "32")
+        options.simdWidth = SimdIntegerWidth::BIT_32;
+    else if (bitWidth == "64")
+        options.simdWidth = SimdIntegerWidth::BIT_64;
+}
+
+template <typename TOptions>
+inline void setAlphabet(TOptions & options, std::string const & alpha)
+{
+    if (alpha == "dna")
+        options.alpha = ScoreAlphabet::DNA;
+    else
+        options.alpha = ScoreAlphabet::AMINOACID;
+}
+
+template <typename TOptions>
+inline void setMethod(TOptions & options, std::string const & method)
+{
+    options.stats.method = method;
+    if (method == "global")
+        options.method = AlignMethod::GLOBAL;
+    else if (method == "semi")
+        options.method = AlignMethod::SEMIGLOBAL;
+    else if (method == "overlap")
+        options.method = AlignMethod::OVERLAP;
+    else if (method == "local")
+        options.method = AlignMethod::LOCAL;
+}
+
+template <typename TOptions>
+inline void setAlignmentMode(TOptions & options, std::string const & mode)
+{
+    if (mode == "pair")
+        options.mode = AlignmentMode::PAIR;
+    else if (mode == "search")
+        options.mode = AlignmentMode::SEARCH;
+    else if (mode == "olc")
+        options.mode = AlignmentMode::OLC;
+}
+
+template <typename TOptions>
+inline void setScalingMode(TOptions & options, std::string const & mode)
+{
+    if (mode == "strong")
+        options.scaling = ScalingMode::STRONG;
+    else if (mode == "weak")
+        options.scaling = ScalingMode::WEAK;
+    else
+        options.scaling = ScalingMode::NONE;
+}
+
 template <typename TParser>
 void setup_parser(TParser & parser)
 {
@@ -58,6 +180,12 @@ void setup_parser(TParser & parser)
     addOption(parser, seqan::ArgParseOption("o", "output", "Output file to write the alignment to.", seqan::ArgParseArgument::OUTPUT_FILE, "OUT"));
     setDefaultValue(parser, "o", "align_bench_res.csv");
 
+    addOption(parser, seqan::ArgParseOption("", "score-format", "Format of the written scores. binary writes a header followed by the raw 32 bit scores.", seqan::ArgParseArgument::STRING, "STR"));
+    setValidValues(parser, "score-format", "text binary");
+    setDefaultValue(parser, "score-format", "text");
+
+    addOption(parser, seqan::ArgParseOption("", "direct-io", "Writes the output file with O_DIRECT, bypassing the page cache, if the file system supports it."));
+
     addOption(parser, seqan::ArgParseOption("s", "simulate", "Number of sequences to be simulated.", seqan::ArgParseArgument::INTEGER, "INT"));
     setDefaultValue(parser, "s", "-1");
 
@@ -69,14 +197,75 @@ void setup_parser(TParser & parser)
 //    setMinValue(parser, "xl", "1000");
     setDefaultValue(parser, "x", "1000");
 
-    addOption(parser, seqan::ArgParseOption("", "pdf", "The probability distribution function to use.", seqan::ArgParseArgument::STRING, "PDF"));
-    setValidValues(parser, "pdf", "uniform normal");
+    addOption(parser, seqan::ArgParseOption("", "pdf", "The probability distribution function of the simulated lengths.", seqan::ArgParseArgument::STRING, "PDF"));
+    setValidValues(parser, "pdf", "uniform normal lognormal gamma pareto empirical");
     setDefaultValue(parser, "pdf", "uniform");
 
+    addOption(parser, seqan::ArgParseOption("", "length-mean", "Mean of the simulated lengths. Defaults to the center of the length range.", seqan::ArgParseArgument::DOUBLE, "DOUBLE"));
+    setMinValue(parser, "length-mean", "0");
+
+    addOption(parser, seqan::ArgParseOption("", "length-sd", "Standard deviation of the normal, lognormal and gamma lengths. Defaults to a sixth of the length range.", seqan::ArgParseArgument::DOUBLE, "DOUBLE"));
+    setMinValue(parser, "length-sd", "0");
+
+    addOption(parser, seqan::ArgParseOption("", "length-shape", "Tail index of the pareto lengths. Defaults to the value matching the mean.", seqan::ArgParseArgument::DOUBLE, "DOUBLE"));
+    setMinValue(parser, "length-shape", "0");
+
+    addOption(parser, seqan::ArgParseOption("", "length-histogram", "File with the empirical length distribution, one length, length and weight, or range and weight per line. Selects the empirical distribution.", seqan::ArgParseArgument::INPUT_FILE, "FILE"));
+
+    addOption(parser, seqan::ArgParseOption("", "length-preset", "Length profile to simulate. Explicitly given length options take precedence.", seqan::ArgParseArgument::STRING, "STR"));
+    setValidValues(parser, "length-preset", "illumina hifi ont uniprot");
+
+    addOption(parser, seqan::ArgParseOption("", "seed", "Seed of the sequence simulation.", seqan::ArgParseArgument::INT64, "INT"));
+    setMinValue(parser, "seed", "0");
+    setMaxValue(parser, "seed", "4294967295");
+    setDefaultValue(parser, "seed", "4294967295");
+
+    addOption(parser, seqan::ArgParseOption("", "identity", "Derives the simulated database from the simulated queries with the given expected identity. The differences are 80% substitutions and 10% insertions and deletions each.", seqan::ArgParseArgument::DOUBLE, "DOUBLE"));
+    setMinValue(parser, "identity", "0");
+    setMaxValue(parser, "identity", "1");
+
+    addOption(parser, seqan::ArgParseOption("", "substitution-rate", "Derives the simulated database from the simulated queries with the given substitution rate per residue.", seqan::ArgParseArgument::DOUBLE, "DOUBLE"));
+    setMinValue(parser, "substitution-rate", "0");
+    setMaxValue(parser, "substitution-rate", "1");
+
+    addOption(parser, seqan::ArgParseOption("", "insertion-rate", "Derives the simulated database from the simulated queries with the given insertion rate per residue.", seqan::ArgParseArgument::DOUBLE, "DOUBLE"));
+    setMinValue(parser, "insertion-rate", "0");
+    setMaxValue(parser, "insertion-rate", "1");
+
+    addOption(parser, seqan::ArgParseOption("", "deletion-rate", "Derives the simulated database from the simulated queries with the given deletion rate per residue.", seqan::ArgParseArgument::DOUBLE, "DOUBLE"));
+    setMinValue(parser, "deletion-rate", "0");
+    setMaxValue(parser, "deletion-rate", "1");
+
+    addOption(parser, seqan::ArgParseOption("", "indel-length", "Mean length of the geometrically distributed insertions and deletions.", seqan::ArgParseArgument::DOUBLE, "DOUBLE"));
+    setMinValue(parser, "indel-length", "1");
+    setDefaultValue(parser, "indel-length", "1");
+
+    addOption(parser, seqan::ArgParseOption("", "dataset", "Aligns a data set of the benchmark suite built by align_bench_datasets instead of QUERY and DATABASE. Sets the alphabet and the alignment mode.", seqan::ArgParseArgument::STRING, "NAME"));
+    setValidValues(parser, "dataset", datasetNames());
+
+    addOption(parser, seqan::ArgParseOption("", "dataset-dir", "Directory of the cached data sets. Defaults to $ALIGN_BENCH_DATASETS or datasets.", seqan::ArgParseArgument::STRING, "DIR"));
+    setDefaultValue(parser, "dataset-dir", defaultDatasetDir());
+
+    addOption(parser, seqan::ArgParseOption("", "families", "Simulates the queries and the database as mutated members of the given number of homologous families. Requires a mutation model, e.g. --identity.", seqan::ArgParseArgument::INTEGER, "INT"));
+    setMinValue(parser, "families", "0");
+    setDefaultValue(parser, "families", "0");
+
+    addOption(parser, seqan::ArgParseOption("", "write-simulated", "Writes the simulated sequences to ref_seq.fa and qry_seq.fa."));
+
     addOption(parser, seqan::ArgParseOption("r", "repetition", "Number of repeated runs.", seqan::ArgParseArgument::INTEGER, "INT"));
     setMinValue(parser, "r", "1");
     setDefaultValue(parser, "r", "1");
 
+    addOption(parser, seqan::ArgParseOption("w", "warmup", "Number of untimed warm-up runs executed before the timed runs.", seqan::ArgParseArgument::INTEGER, "INT"));
+    setMinValue(parser, "w", "0");
+    setDefaultValue(parser, "w", "0");
+
+    addOption(parser, seqan::ArgParseOption("", "flush-cache", "Evicts the last-level cache before every run to measure cold-cache performance."));
+
+    addOption(parser, seqan::ArgParseOption("", "hw-counters", "Records hardware performance counters of the timed runs (Linux only)."));
+
+    addOption(parser, seqan::ArgParseOption("", "latency", "Issues the alignments in chunks and reports the percentiles of the per-alignment completion latency."));
+
     addOption(parser, seqan::ArgParseOption("i", "integer-width", "Width of integers in bits used for score", seqan::ArgParseArgument::STRING, "STR"));
     setValidValues(parser, "i", "8 16 32 64");
     setDefaultValue(parser, "i", "32");
@@ -94,12 +283,32 @@ void setup_parser(TParser & parser)
     addOption(parser, seqan::ArgParseOption("", "upper-diagonal", "Upper diagonal of band.", seqan::ArgParseArgument::INTEGER, "INT"));
 #endif // ALIGN_BENCH_BANDED
 
+#if defined(ALIGN_BENCH_TRACE)
+    addOption(parser, seqan::ArgParseOption("", "split-traceback", "Additionally times score-only passes to report the score and the traceback phase separately."));
+
+    addOption(parser, seqan::ArgParseOption("", "align-format", "Format of the written alignments. cigar, sam and paf convert the alignments of every batch of --pair-batch pairs to CIGAR strings and release the gapped rows.", seqan::ArgParseArgument::STRING, "STR"));
+    setValidValues(parser, "align-format", "gaps cigar sam paf");
+    setDefaultValue(parser, "align-format", "gaps");
+#endif // ALIGN_BENCH_TRACE
+
     addOption(parser, seqan::ArgParseOption("", "alignment-mode", "How the input sequences should be aligned", seqan::ArgParseArgument::STRING, "STRING"));
     setValidValues(parser, "alignment-mode", "pair search olc");
     setDefaultValue(parser, "alignment-mode", "pair");
 
     addOption(parser, seqan::ArgParseOption("", "sort-sequences", "Whether the input sequences should be sorted by their lengths"));
 
+    addOption(parser, seqan::ArgParseOption("", "mmap-input", "Reads the FASTA inputs through a read-only memory mapping and converts the residues of all records into a single string instead of one string per record."));
+
+    addOption(parser, seqan::ArgParseOption("", "reader-threads", "Number of threads parsing the FASTA/FASTQ inputs.", seqan::ArgParseArgument::INTEGER, "INT"));
+    setMinValue(parser, "reader-threads", "1");
+    setDefaultValue(parser, "reader-threads", toString(defaultThreadCount()));
+
+    addOption(parser, seqan::ArgParseOption("", "pair-batch", "Aligns the pairs of the search and OLC modes in batches of the given size, which are built on demand instead of holding views of all pairs. 0 materializes and aligns all pairs at once, as the pair mode always does.", seqan::ArgParseArgument::INT64, "INT"));
+    setMinValue(parser, "pair-batch", "0");
+    setDefaultValue(parser, "pair-batch", std::to_string(DEFAULT_PAIR_BATCH));
+
+    addOption(parser, seqan::ArgParseOption("", "packed", "Stores the sequences bit-packed, 3 bits per nucleotide and 5 bits per amino acid. Mapped inputs are copied into packed strings."));
+
     addOption(parser, seqan::ArgParseOption("v", "vectorization", "If set, executes vectorized alignment code."));
 }
 
@@ -110,66 +319,88 @@ inline void get_arguments(TOptions & options, TParser & parser)
     getArgumentValue(options.databaseFile, parser, 1);
 
     getOptionValue(options.alignOut, parser, "o");
+    std::string scoreFormat;
+    getOptionValue(scoreFormat, parser, "score-format");
+    options.scoreFormat = (scoreFormat == "binary") ? ScoreFormat::BINARY : ScoreFormat::TEXT;
+    options.directIo = isSet(parser, "direct-io");
     getOptionValue(options.rep, parser, "r");
+    getOptionValue(options.warmup, parser, "w");
+    options.flushCache = isSet(parser, "flush-cache");
+    options.hwCounters = isSet(parser, "hw-counters");
+    options.latency = isSet(parser, "latency");
     getOptionValue(options.numSequences, parser, "s");
-    getOptionValue(options.minSize, parser, "m");
-    getOptionValue(options.maxSize, parser, "x");
 
     std::string tmp;
 
+    // A preset replaces the defaults of the length options, explicitly given ones take precedence.
     clear(tmp);
-    if (getOptionValue(tmp, parser, "pdf"))
-    {
-        if (tmp == "normal")
-            options.distFunction = DistributionFunction::NORMAL_DISTRIBUTION;
-        else if (tmp == "uniform")
-            options.distFunction = DistributionFunction::UNIFORM_DISTRIBUTION;
-    }
+    bool const preset = getOptionValue(tmp, parser, "length-preset");
+    if (preset)
+        setLengthPreset(options, tmp);
+    if (!preset || isSet(parser, "m"))
+        getOptionValue(options.minSize, parser, "m");
+    if (!preset || isSet(parser, "x"))
+        getOptionValue(options.maxSize, parser, "x");
+    clear(tmp);
+    if ((!preset || isSet(parser, "pdf")) && getOptionValue(tmp, parser, "pdf"))
+        setDistribution(options, tmp);
+    getOptionValue(options.lengths.mean, parser, "length-mean");
+    getOptionValue(options.lengths.sd, parser, "length-sd");
+    getOptionValue(options.lengths.shape, parser, "length-shape");
+    if (getOptionValue(options.lengths.histogramFile, parser, "length-histogram") && !isSet(parser, "pdf"))
+        options.distFunction = DistributionFunction::EMPIRICAL_DISTRIBUTION;
+
+    options.writeSimulated = isSet(parser, "write-simulated");
+    int64_t seed = 0;
+    getOptionValue(seed, parser, "seed");
+    options.seed = static_cast<uint32_t>(seed);
+
+    // The identity sets all rates, the explicit rates refine it.
+    getOptionValue(options.mutation.meanIndelLength, parser, "indel-length");
+    double identity = 1.0;
+    if (getOptionValue(identity, parser, "identity"))
+        setMutationIdentity(options.mutation, identity);
+    if (getOptionValue(options.mutation.substitutionRate, parser, "substitution-rate"))
+        options.mutation.enabled = true;
+    if (getOptionValue(options.mutation.insertionRate, parser, "insertion-rate"))
+        options.mutation.enabled = true;
+    if (getOptionValue(options.mutation.deletionRate, parser, "deletion-rate"))
+        options.mutation.enabled = true;
+    getOptionValue(options.families, parser, "families");
 
     std::string bitWidth;
     getOptionValue(bitWidth, parser, "i");
-    if (bitWidth == "8")
-        options.simdWidth = SimdIntegerWidth::BIT_8;
-    else if (bitWidth == "16")
-        options.simdWidth = SimdIntegerWidth::BIT_16;
-    else if (bitWidth == "32")
-        options.simdWidth = SimdIntegerWidth::BIT_32;
-    else if (bitWidth == "64")
-        options.simdWidth = SimdIntegerWidth::BIT_64;
+    setIntegerWidth(options, bitWidth);
 
     std::string alpha;
     getOptionValue(alpha, parser, "a");
-    if (alpha == "dna")
-        options.alpha = ScoreAlphabet::DNA;
-    else
-        options.alpha = ScoreAlphabet::AMINOACID;
+    setAlphabet(options, alpha);
 
     if (getOptionValue(options.stats.method, parser, "d"))
-    {
-        if (options.stats.method == "global")
-            options.method = AlignMethod::GLOBAL;
-        else if (options.stats.method == "semi")
-            options.method = AlignMethod::SEMIGLOBAL;
-        else if (options.stats.method == "overlap")
-            options.method = AlignMethod::OVERLAP;
-        else if (options.stats.method == "local")
-            options.method = AlignMethod::LOCAL;
-        }
+        setMethod(options, options.stats.method);
 
     clear(tmp);
     if (getOptionValue(tmp, parser, "alignment-mode"))
-    {
-        if (tmp == "pair")
-            options.mode = AlignmentMode::PAIR;
-        else if (tmp == "search")
-            options.mode = AlignmentMode::SEARCH;
-        else if (tmp == "olc")
-            options.mode = AlignmentMode::OLC;
-    }
+        setAlignmentMode(options, tmp);
 
     options.sortSequences = isSet(parser, "sort-sequences");
+    options.mmapInput = isSet(parser, "mmap-input");
+    options.packed = isSet(parser, "packed");
+    int64_t pairBatch = DEFAULT_PAIR_BATCH;
+    getOptionValue(pairBatch, parser, "pair-batch");
+    options.pairBatch = pairBatch;
+    getOptionValue(options.readerThreads, parser, "reader-threads");
     options.simd = isSet(parser, "v");
 
+    // Applied last, since the data set takes precedence over the input, alphabet and mode options.
+    clear(tmp);
+    if (getOptionValue(tmp, parser, "dataset"))
+    {
+        std::string dir;
+        getOptionValue(dir, parser, "dataset-dir");
+        setDataset(options, *findBenchmarkDataset(tmp), dir);
+    }
+
 #if defined(ALIGN_BENCH_BANDED)
     if (isSet(parser, "lower-diagonal") && isSet(parser, "upper-diagonal"))
     {
@@ -178,6 +409,21 @@ inline void get_arguments(TOptions & options, TParser & parser)
         getOptionValue(options.upper, parser, "upper-diagonal");
     }
 #endif // ALIGN_BENCH_BANDED
+
+#if defined(ALIGN_BENCH_TRACE)
+    options.splitTraceback = isSet(parser, "split-traceback");
+
+    clear(tmp);
+    getOptionValue(tmp, parser, "align-format");
+    if (tmp == "cigar")
+        options.alignFormat = AlignmentFormat::CIGAR;
+    else if (tmp == "sam")
+        options.alignFormat = AlignmentFormat::SAM;
+    else if (tmp == "paf")
+        options.alignFormat = AlignmentFormat::PAF;
+    else
+        options.alignFormat = AlignmentFormat::GAPS;
+#endif // ALIGN_BENCH_TRACE
 }
 
 #endif // ALIGN_BENCH_PARSER_HPP_
@@ -69,6 +69,7 @@ int main(int argc, char* argv[])
 
     if (options.simd)
     {
+        options.stats.vectorLength = SEQAN_SIZEOF_MAX_VECTOR / static_cast<unsigned>(options.simdWidth);
         seqan::ExecutionPolicy<seqan::Serial, seqan::Vectorial> exec_policy;
         configureAlpha(options, exec_policy);
     }
@@ -38,138 +38,515 @@
 #include <seqan/basic.h>
 #include <seqan/align_parallel.h>
 
+#include <sstream>
+#include <string>
+#include <tuple>
+
 #include "benchmark_executor.hpp"
+#include "output_writer.hpp"
+#include "compact_alignment.hpp"
 
 using namespace seqan;
 
 
+// ----------------------------------------------------------------------------
+// Function writeAlignment()
+// ----------------------------------------------------------------------------
+
+// The alignments are printed in chunks on options.threadCount threads and written in their original order.
 template <typename TGapsH, typename TGapsV>
 inline void writeAlignment(AlignBenchOptions const & options,
                            TGapsH const & gapsH,
                            TGapsV const & gapsV)
 {
-    auto printGaps = [&](auto & stream)
+    if (options.alignOut.empty())
+        return;
+
+    OutputFile alignOut;
+    if (!alignOut.open(options.alignOut, options.directIo))
     {
-        for (unsigned i = 0; i < length(gapsH); ++i)
+        std::cerr << "Could not open file << " << options.alignOut.c_str() << ">>!" << std::endl;
+        return;
+    }
+
+    writeOrderedChunks(alignOut, length(gapsH), 256, options.threadCount,
+                       [&] (std::string & buffer, size_t first, size_t last)
+    {
+        std::ostringstream stream;
+        for (size_t i = first; i < last; ++i)
         {
-            stream << "Alignment no. " << i << std::endl;
-            stream << "Score: " << options.stats.scores[i] << std::endl;
-            stream << gapsH[i] << std::endl;
-            stream << gapsV[i] << std::endl;
+            stream << "Alignment no. " << i << '\n';
+            stream << "Score: " << options.stats.scores[i] << '\n';
+            stream << gapsH[i] << '\n';
+            stream << gapsV[i] << '\n';
         }
-    };
-    if (options.alignOut == "stdout")
+        buffer += stream.str();
+    });
+
+    if (!alignOut.close())
+        std::cerr << "Could not write file << " << options.alignOut.c_str() << ">>!" << std::endl;
+}
+
+// ----------------------------------------------------------------------------
+// Function writeCompactAlignments()
+// ----------------------------------------------------------------------------
+
+// Writes the alignments as CIGAR, SAM or PAF records numbered in pair order.
+inline void writeCompactAlignments(AlignBenchOptions const & options,
+                                   std::vector<CompactAlignment> const & alignments)
+{
+    if (options.alignOut.empty())
+        return;
+
+    OutputFile alignOut;
+    if (!alignOut.open(options.alignOut, options.directIo))
     {
-        printGaps(std::cout);
+        std::cerr << "Could not open file << " << options.alignOut.c_str() << ">>!" << std::endl;
         return;
     }
 
-    std::ofstream alignOut;
-    alignOut.open(options.alignOut.c_str());
-    if (!alignOut.good())
+    if (options.alignFormat == AlignmentFormat::SAM)
+    {
+        alignOut.write(std::string("@HD\tVN:1.6\tSO:unsorted\n"));
+        writeOrderedChunks(alignOut, alignments.size(), 4096, options.threadCount,
+                           [&] (std::string & buffer, size_t first, size_t last)
+        {
+            for (size_t i = first; i < last; ++i)
+                appendSamReference(buffer, i, alignments[i]);
+        });
+    }
+
+    writeOrderedChunks(alignOut, alignments.size(), 4096, options.threadCount,
+                       [&] (std::string & buffer, size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; ++i)
+        {
+            switch (options.alignFormat)
+            {
+                case AlignmentFormat::SAM:
+                    appendSamRecord(buffer, i, alignments[i], options.stats.scores[i]);
+                    break;
+                case AlignmentFormat::PAF:
+                    appendPafRecord(buffer, i, alignments[i], options.stats.scores[i]);
+                    break;
+                default:
+                    appendCigarRecord(buffer, i, alignments[i], options.stats.scores[i]);
+            }
+        }
+    });
+
+    if (!alignOut.close())
+        std::cerr << "Could not write file << " << options.alignOut.c_str() << ">>!" << std::endl;
+}
+
+// ----------------------------------------------------------------------------
+// Function writeScores()
+// ----------------------------------------------------------------------------
+
+inline void writeScores(AlignBenchOptions const & options)
+{
+    if (options.alignOut.empty())
+        return;
+
+    OutputFile alignOut;
+    if (!alignOut.open(options.alignOut, options.directIo))
     {
         std::cerr << "Could not open file << " << options.alignOut.c_str() << ">>!" << std::endl;
         return;
     }
-    printGaps(alignOut);
-    alignOut.close();
+
+    if (options.scoreFormat == ScoreFormat::BINARY)
+        writeScoresBinary(alignOut, options.stats.scores);
+    else
+        writeScoresText(alignOut, options.stats.scores, options.threadCount);
+
+    if (!alignOut.close())
+        std::cerr << "Could not write file << " << options.alignOut.c_str() << ">>!" << std::endl;
 }
 
-template <typename TStream, typename TResultVec>
-inline void writeScores_(TStream & stream,
-                        TResultVec const & vec)
+// ----------------------------------------------------------------------------
+// Function latencyChunking()
+// ----------------------------------------------------------------------------
+
+// Returns the policy used to align one chunk, the number of chunks aligned concurrently and the chunk size.
+template <typename TExecPolicy>
+inline auto
+latencyChunking(AlignBenchOptions const & options, TExecPolicy const & execPolicy)
 {
-    std::for_each(std::begin(vec), std::end(vec), [&](auto & sc) { stream << sc << ",\n"; });
-    stream << "\n";
+    return std::make_tuple(execPolicy, 1u, std::max<unsigned>(options.stats.vectorLength, 1u));
 }
 
-inline void writeScores(AlignBenchOptions const & options)
+// The parallel policy distributes vector-sized chunks over the threads, each aligned with the serial policy. The
+// stats mark such runs, see BenchmarkExecutor::isLatencyChunked().
+template <typename TVectorSpec>
+inline auto
+latencyChunking(AlignBenchOptions const & options, ExecutionPolicy<Parallel, TVectorSpec> const & /*execPolicy*/)
 {
-    if (options.alignOut == "stdout")
-    {
-        writeScores_(std::cout, options.stats.scores);
-    } else
+    return std::make_tuple(ExecutionPolicy<Serial, TVectorSpec>{},
+                           std::max(options.threadCount, 1u),
+                           std::max<unsigned>(options.stats.vectorLength, 1u));
+}
+
+// The wavefront policy already schedules its tiles on all threads, so the batches of concurrently aligned
+// instances are issued one after another.
+template <typename TWaveSpec, typename TVectorSpec>
+inline auto
+latencyChunking(AlignBenchOptions const & options,
+                ExecutionPolicy<WavefrontAlignment<TWaveSpec>, TVectorSpec> const & execPolicy)
+{
+    return std::make_tuple(execPolicy, 1u, std::max(options.parallelInstances, 1u));
+}
+
+// ----------------------------------------------------------------------------
+// Member Function BenchmarkExecutor::runInstrumented()
+// ----------------------------------------------------------------------------
+
+template <typename TExecPolicy,
+          typename TSet1,
+          typename TSet2,
+          typename TFunc>
+inline auto
+BenchmarkExecutor::runInstrumented(AlignBenchOptions const & options,
+                                   TExecPolicy const & execPolicy,
+                                   TSet1 & set1,
+                                   TSet2 & set2,
+                                   TFunc && func)
+{
+    auto chunking = latencyChunking(options, execPolicy);
+    auto const & chunkPolicy = std::get<0>(chunking);
+    unsigned const threads = std::get<1>(chunking);
+    size_t const chunkSize = std::get<2>(chunking);
+    mLatencyChunked = !std::is_same<std::decay_t<decltype(chunkPolicy)>, TExecPolicy>::value;
+
+    decltype(func(chunkPolicy, set1, set2)) res;
+    resize(res, length(set1), Exact());
+
+    size_t const numChunks = (length(set1) + chunkSize - 1) / chunkSize;
+    std::vector<double> completion(length(set1), 0.0);
+
+    double const batchBegin = sysTime();
+    SEQAN_OMP_PRAGMA(parallel for schedule(dynamic) num_threads(threads))
+    for (int64_t chunk = 0; chunk < static_cast<int64_t>(numChunks); ++chunk)
     {
-        std::ofstream alignOut;
-        alignOut.open(options.alignOut.c_str());
-        if (!alignOut.good())
+        size_t const chunkBegin = chunk * chunkSize;
+        size_t const chunkEnd = std::min(chunkBegin + chunkSize, static_cast<size_t>(length(set1)));
+
+        StringSet<typename Value<TSet1>::Type, Dependent<Tight>> chunkSet1;
+        StringSet<typename Value<TSet2>::Type, Dependent<Tight>> chunkSet2;
+        for (size_t i = chunkBegin; i < chunkEnd; ++i)
         {
-            std::cerr << "Could not open file << " << options.alignOut.c_str() << ">>!" << std::endl;
-            return;
+            appendValue(chunkSet1, set1[i]);
+            appendValue(chunkSet2, set2[i]);
         }
-        writeScores_(alignOut, options.stats.scores);
+
+        auto chunkRes = func(chunkPolicy, chunkSet1, chunkSet2);
+        double const chunkEndTime = sysTime();
+        for (size_t i = chunkBegin; i < chunkEnd; ++i)
+        {
+            res[i] = chunkRes[i - chunkBegin];
+            completion[i] = chunkEndTime - batchBegin;
+        }
+    }
+
+    for (double latency : completion)
+        mLatencyHistogram.record(static_cast<uint64_t>(latency * 1e9));
+    return res;
+}
+
+// ----------------------------------------------------------------------------
+// Member Function BenchmarkExecutor::runBatches()
+// ----------------------------------------------------------------------------
+
+/*!
+ * @fn BenchmarkExecutor#runBatches
+ * @brief Aligns lazily computed pairs in batches of <tt>options.pairBatch</tt> pairs.
+ *
+ * Every batch is materialized into string sets of views, which are reused for all batches, and aligned with
+ * <tt>func</tt>. Thus, the pair views take memory proportional to the batch size instead of the number of
+ * alignments. The batch size is given by @link pairBatchSize @endlink. The time of materializing the batches is
+ * added to <tt>pairsTime</tt>. With <tt>options.latency</tt> set, every batch is issued in chunks by
+ * @link BenchmarkExecutor#runInstrumented @endlink and the latencies refer to the start of the batch.
+ */
+template <typename TExecPolicy, typename TView, typename TFunc>
+inline auto
+BenchmarkExecutor::runBatches(AlignBenchOptions const & options,
+                              TExecPolicy const & execPolicy,
+                              LazyPairSet<TView> const & set1,
+                              LazyPairSet<TView> const & set2,
+                              double & pairsTime,
+                              TFunc && func)
+{
+    size_t const batchSize = pairBatchSize(options, set1);
+
+    StringSet<TView> batchH;
+    StringSet<TView> batchV;
+    decltype(func(execPolicy, batchH, batchV)) res;
+    resize(res, length(set1), Exact());
+
+    for (size_t first = 0; first < length(set1); first += batchSize)
+    {
+        size_t const last = std::min(first + batchSize, length(set1));
+        double const pairsBegin = sysTime();
+        materialize(batchH, set1, first, last);
+        materialize(batchV, set2, first, last);
+        pairsTime += sysTime() - pairsBegin;
+
+        decltype(func(execPolicy, batchH, batchV)) batchRes;
+        if (options.latency)
+            batchRes = runInstrumented(options, execPolicy, batchH, batchV, func);
+        else
+            batchRes = func(execPolicy, batchH, batchV);
+
+        for (size_t k = first; k < last; ++k)
+            res[k] = batchRes[k - first];
     }
+    return res;
 }
 
 #if defined(ALIGN_BENCH_TRACE)
+// ----------------------------------------------------------------------------
+// Member Function BenchmarkExecutor::measureScorePass()
+// ----------------------------------------------------------------------------
+
+// Times the score-only variant of the configured alignment and returns the mean time of a pass without building the
+// pairs of the batches.
 template <typename TExecPolicy,
           typename TSet1,
           typename TSet2,
           typename TScore>
+inline double
+BenchmarkExecutor::measureScorePass(AlignBenchOptions const & options,
+                                    TExecPolicy const & execPolicy,
+                                    TSet1 & set1,
+                                    TSet2 & set2,
+                                    TScore const & scoreMat)
+{
+    // The counters, latencies and memory stats are recorded by the following traceback passes.
+    AlignBenchOptions scoreOptions;
+    scoreOptions.rep = options.rep;
+    scoreOptions.warmup = options.warmup;
+    scoreOptions.flushCache = options.flushCache;
+
+    scoreOptions.pairBatch = options.pairBatch;
+    scoreOptions.stats.vectorLength = options.stats.vectorLength;
+
+    auto scorePass = [&] (auto && align)
+    {
+        run(scoreOptions, execPolicy, set1, set2, align);
+    };
+
+#if defined(ALIGN_BENCH_BANDED)
+    if (options.isBanded)
+    {
+        switch (options.method)
+        {
+            case AlignMethod::GLOBAL:
+                scorePass([&] (auto const & policy, auto & setH, auto & setV)
+                {
+                    return globalAlignmentScore(policy, setH, setV, scoreMat, options.lower, options.upper);
+                });
+                break;
+            case AlignMethod::LOCAL:
+                scorePass([&] (auto const & policy, auto & setH, auto & setV)
+                {
+                    return localAlignmentScore(policy, setH, setV, scoreMat, options.lower, options.upper);
+                });
+                break;
+            case AlignMethod::SEMIGLOBAL:
+                scorePass([&] (auto const & policy, auto & setH, auto & setV)
+                {
+                    return globalAlignmentScore(policy, setH, setV, scoreMat, AlignConfig<true, false, false, true>{}, options.lower, options.upper);
+                });
+                break;
+            case AlignMethod::OVERLAP:
+                scorePass([&] (auto const & policy, auto & setH, auto & setV)
+                {
+                    return globalAlignmentScore(policy, setH, setV, scoreMat, AlignConfig<true, true, true, true>{}, options.lower, options.upper);
+                });
+                break;
+        }
+        return kernelTime();
+    }
+#endif // ALIGN_BENCH_BANDED
+
+    switch (options.method)
+    {
+        case AlignMethod::GLOBAL:
+            scorePass([&] (auto const & policy, auto & setH, auto & setV)
+            {
+                return globalAlignmentScore(policy, setH, setV, scoreMat);
+            });
+            break;
+        case AlignMethod::LOCAL:
+            scorePass([&] (auto const & policy, auto & setH, auto & setV)
+            {
+                return localAlignmentScore(policy, setH, setV, scoreMat);
+            });
+            break;
+        case AlignMethod::SEMIGLOBAL:
+            scorePass([&] (auto const & policy, auto & setH, auto & setV)
+            {
+                return globalAlignmentScore(policy, setH, setV, scoreMat, AlignConfig<true, false, false, true>{});
+            });
+            break;
+        case AlignMethod::OVERLAP:
+            scorePass([&] (auto const & policy, auto & setH, auto & setV)
+            {
+                return globalAlignmentScore(policy, setH, setV, scoreMat, AlignConfig<true, true, true, true>{});
+            });
+            break;
+    }
+    return kernelTime();
+}
+
+// ----------------------------------------------------------------------------
+// Member Function BenchmarkExecutor::runTrace()
+// ----------------------------------------------------------------------------
+
+/*!
+ * @fn BenchmarkExecutor#runTrace
+ * @brief Runs the alignment with traceback <tt>func</tt> and writes the alignments in <tt>options.alignFormat</tt>.
+ *
+ * Alignments printed as gapped rows keep a <tt>Gaps</tt> object per pair until they are written.
+ * For CIGAR, SAM and PAF output the pairs are aligned in batches, see @link pairBatchSize @endlink, into
+ * <tt>Gaps</tt> objects reused for all batches. Filling the <tt>Gaps</tt> objects is accounted to the pairs phase.
+ * Right after a batch was aligned its rows are converted into @link CompactAlignment @endlink records on
+ * <tt>options.threadCount</tt> threads, which is part of the timed traceback.
+ */
+template <typename TExecPolicy, typename TSet1, typename TSet2, typename TFunc>
 inline void
-BenchmarkExecutor::runAlignmentTrace(AlignBenchOptions & options,
-                                     TExecPolicy const & execPolicy,
-                                     TSet1 & set1,
-                                     TSet2 & set2,
-                                     TScore const & scoreMat)
+BenchmarkExecutor::runTrace(AlignBenchOptions & options,
+                            TExecPolicy const & execPolicy,
+                            TSet1 & set1,
+                            TSet2 & set2,
+                            double const scorePassTime,
+                            TFunc && func)
 {
-    options.stats.isBanded = "no";
     using TSeqH = typename Value<TSet1>::Type;
     using TSeqV = typename Value<TSet2>::Type;
     StringSet<Gaps<TSeqH>> gapsSet1;
     StringSet<Gaps<TSeqV>> gapsSet2;
 
-    auto fillGaps = [](auto & gaps, auto & sequences)
+    auto fillGaps = [](auto & gaps, auto & sequences, size_t const first, size_t const last)
     {
-        resize(gaps, length(sequences), Exact{});
-        for (unsigned i = 0; i < length(sequences); ++i)
+        resize(gaps, last - first, Exact{});
+        for (size_t i = first; i < last; ++i)
         {
-            assignSource(gaps[i], sequences[i]);
+            assignSource(gaps[i - first], sequences[i]);
         }
     };
-    fillGaps(gapsSet1, set1);
-    fillGaps(gapsSet2, set2);
+
+    resize(options.stats.scores, length(set1), Exact());
+    if (options.alignFormat == AlignmentFormat::GAPS)
+    {
+        {
+            ScopedPhase pairsPhase(mPhases, Phase::PAIRS);
+            fillGaps(gapsSet1, set1, 0, length(set1));
+            fillGaps(gapsSet2, set2, 0, length(set2));
+        }
+
+        auto res = run(options, execPolicy, gapsSet1, gapsSet2, func);
+        seqan::arrayMoveForward(begin(res, Standard()), end(res, Standard()), begin(options.stats.scores, Standard()));
+        addKernelPhases(scorePassTime);
+
+        ScopedPhase outputPhase(mPhases, Phase::OUTPUT);
+        writeAlignment(options, gapsSet1, gapsSet2);
+        return;
+    }
+
+    size_t const numPairs = length(set1);
+    size_t const batchSize = pairBatchSize(options, set1);
+    std::vector<CompactAlignment> alignments(numPairs);
+
+    double pairsTime = 0.0;
+    unsigned passes = 0;
+    auto res = measure(options, [&] ()
+    {
+        ++passes;
+        decltype(func(execPolicy, gapsSet1, gapsSet2)) passRes;
+        resize(passRes, numPairs, Exact());
+        for (size_t first = 0; first < numPairs; first += batchSize)
+        {
+            size_t const last = std::min(first + batchSize, numPairs);
+            double const pairsBegin = sysTime();
+            fillGaps(gapsSet1, set1, first, last);
+            fillGaps(gapsSet2, set2, first, last);
+            pairsTime += sysTime() - pairsBegin;
+
+            decltype(func(execPolicy, gapsSet1, gapsSet2)) batchRes;
+            if (options.latency)
+                batchRes = runInstrumented(options, execPolicy, gapsSet1, gapsSet2, func);
+            else
+                batchRes = func(execPolicy, gapsSet1, gapsSet2);
+
+            SEQAN_OMP_PRAGMA(parallel for schedule(dynamic, 64) num_threads(std::max(options.threadCount, 1u)))
+            for (int64_t k = first; k < static_cast<int64_t>(last); ++k)
+                compactAlignment(alignments[k], gapsSet1[k - first], gapsSet2[k - first]);
+
+            for (size_t k = first; k < last; ++k)
+                passRes[k] = batchRes[k - first];
+        }
+        return passRes;
+    });
+    addBatchPairsTime(pairsTime / passes);
+    clear(gapsSet1);
+    clear(gapsSet2);
+
+    seqan::arrayMoveForward(begin(res, Standard()), end(res, Standard()), begin(options.stats.scores, Standard()));
+    addKernelPhases(scorePassTime);
+
+    ScopedPhase outputPhase(mPhases, Phase::OUTPUT);
+    writeCompactAlignments(options, alignments);
+}
+
+// ----------------------------------------------------------------------------
+// Member Function BenchmarkExecutor::runAlignmentTrace()
+// ----------------------------------------------------------------------------
+
+template <typename TExecPolicy,
+          typename TSet1,
+          typename TSet2,
+          typename TScore>
+inline void
+BenchmarkExecutor::runAlignmentTrace(AlignBenchOptions & options,
+                                     TExecPolicy const & execPolicy,
+                                     TSet1 & set1,
+                                     TSet2 & set2,
+                                     TScore const & scoreMat)
+{
+    options.stats.isBanded = "no";
+    mCells = countCells(options, execPolicy, set1, set2);
+
+    double const scorePassTime = (options.splitTraceback) ? measureScorePass(options, execPolicy, set1, set2, scoreMat)
+                                                          : -1.0;
 
     switch (options.method)
     {
         case AlignMethod::GLOBAL:
-        {
-            resize(options.stats.scores, length(gapsSet1), Exact());
-            start(mTimer);
-            auto res = globalAlignment(execPolicy, gapsSet1, gapsSet2, scoreMat);
-            stop(mTimer);
-            seqan::arrayMoveForward(begin(res, Standard()), end(res, Standard()), begin(options.stats.scores, Standard()));
+            runTrace(options, execPolicy, set1, set2, scorePassTime, [&] (auto const & policy, auto & setH, auto & setV)
+            {
+                return globalAlignment(policy, setH, setV, scoreMat);
+            });
             break;
-        }
         case AlignMethod::LOCAL:
-        {
-            resize(options.stats.scores, length(gapsSet1), Exact());
-            start(mTimer);
-            auto res = localAlignment(execPolicy, gapsSet1, gapsSet2, scoreMat);
-            stop(mTimer);
-            seqan::arrayMoveForward(begin(res, Standard()), end(res, Standard()), begin(options.stats.scores, Standard()));
+            runTrace(options, execPolicy, set1, set2, scorePassTime, [&] (auto const & policy, auto & setH, auto & setV)
+            {
+                return localAlignment(policy, setH, setV, scoreMat);
+            });
             break;
-        }
         case AlignMethod::SEMIGLOBAL:
-        {
-            resize(options.stats.scores, length(gapsSet1), Exact());
-            start(mTimer);
-            auto res = globalAlignment(execPolicy, gapsSet1, gapsSet2, scoreMat, AlignConfig<true, false, false, true>{});
-            stop(mTimer);
-            seqan::arrayMoveForward(begin(res, Standard()), end(res, Standard()), begin(options.stats.scores, Standard()));
+            runTrace(options, execPolicy, set1, set2, scorePassTime, [&] (auto const & policy, auto & setH, auto & setV)
+            {
+                return globalAlignment(policy, setH, setV, scoreMat, AlignConfig<true, false, false, true>{});
+            });
             break;
-        }
         case AlignMethod::OVERLAP:
-        {
-            resize(options.stats.scores, length(gapsSet1), Exact());
-            start(mTimer);
-            auto res = globalAlignment(execPolicy, gapsSet1, gapsSet2, scoreMat, AlignConfig<true, true, true, true>{});
-            stop(mTimer);
-            seqan::arrayMoveForward(begin(res, Standard()), end(res, Standard()), begin(options.stats.scores, Standard()));
+            runTrace(options, execPolicy, set1, set2, scorePassTime, [&] (auto const & policy, auto & setH, auto & setV)
+            {
+                return globalAlignment(policy, setH, setV, scoreMat, AlignConfig<true, true, true, true>{});
+            });
             break;
-        }
     }
-    writeAlignment(options, gapsSet1, gapsSet2);
 }
 
 template <typename TExecPolicy,
@@ -184,63 +561,38 @@ BenchmarkExecutor::runAlignmentBandedTrace(AlignBenchOptions & options,
                                            TScore const & scoreMat)
 {
     options.stats.isBanded = "yes";
+    mCells = countCells(options, execPolicy, set1, set2);
 
-    using TSeqH = typename Value<TSet1>::Type;
-    using TSeqV = typename Value<TSet2>::Type;
-    StringSet<Gaps<TSeqH>> gapsSet1;
-    StringSet<Gaps<TSeqV>> gapsSet2;
-
-    auto fillGaps = [](auto & gaps, auto & sequences)
-    {
-        resize(gaps, length(sequences), Exact{});
-        for (unsigned i = 0; i < length(sequences); ++i)
-        {
-            assignSource(gaps[i], sequences[i]);
-        }
-    };
-    fillGaps(gapsSet1, set1);
-    fillGaps(gapsSet2, set2);
+    double const scorePassTime = (options.splitTraceback) ? measureScorePass(options, execPolicy, set1, set2, scoreMat)
+                                                          : -1.0;
 
     switch (options.method)
     {
         case AlignMethod::GLOBAL:
-        {
-            resize(options.stats.scores, length(gapsSet1), Exact());
-            start(mTimer);
-            auto res = globalAlignment(execPolicy, gapsSet1, gapsSet2, scoreMat, options.lower, options.upper);
-            stop(mTimer);
-            seqan::arrayMoveForward(begin(res, Standard()), end(res, Standard()), begin(options.stats.scores, Standard()));
+            runTrace(options, execPolicy, set1, set2, scorePassTime, [&] (auto const & policy, auto & setH, auto & setV)
+            {
+                return globalAlignment(policy, setH, setV, scoreMat, options.lower, options.upper);
+            });
             break;
-        }
         case AlignMethod::LOCAL:
-        {
-            resize(options.stats.scores, length(gapsSet1), Exact());
-            start(mTimer);
-            auto res = localAlignment(execPolicy, gapsSet1, gapsSet2, scoreMat, options.lower, options.upper);
-            stop(mTimer);
-            seqan::arrayMoveForward(begin(res, Standard()), end(res, Standard()), begin(options.stats.scores, Standard()));
+            runTrace(options, execPolicy, set1, set2, scorePassTime, [&] (auto const & policy, auto & setH, auto & setV)
+            {
+                return localAlignment(policy, setH, setV, scoreMat, options.lower, options.upper);
+            });
             break;
-        }
         case AlignMethod::SEMIGLOBAL:
-        {
-            resize(options.stats.scores, length(gapsSet1), Exact());
-            start(mTimer);
-            auto res = globalAlignment(execPolicy, gapsSet1, gapsSet2, scoreMat, AlignConfig<true, false, false, true>{}, options.lower, options.upper);
-            stop(mTimer);
-            seqan::arrayMoveForward(begin(res, Standard()), end(res, Standard()), begin(options.stats.scores, Standard()));
+            runTrace(options, execPolicy, set1, set2, scorePassTime, [&] (auto const & policy, auto & setH, auto & setV)
+            {
+                return globalAlignment(policy, setH, setV, scoreMat, AlignConfig<true, false, false, true>{}, options.lower, options.upper);
+            });
             break;
-        }
         case AlignMethod::OVERLAP:
-        {
-            resize(options.stats.scores, length(gapsSet1), Exact());
-            start(mTimer);
-            auto res = globalAlignment(execPolicy, gapsSet1, gapsSet2, scoreMat, AlignConfig<true, true, true, true>{}, options.lower, options.upper);
-            stop(mTimer);
-            seqan::arrayMoveForward(begin(res, Standard()), end(res, Standard()), begin(options.stats.scores, Standard()));
+            runTrace(options, execPolicy, set1, set2, scorePassTime, [&] (auto const & policy, auto & setH, auto & setV)
+            {
+                return globalAlignment(policy, setH, setV, scoreMat, AlignConfig<true, true, true, true>{}, options.lower, options.upper);
+            });
             break;
-        }
     }
-    writeAlignment(options, gapsSet1, gapsSet2);
 }
 
 #else // ALIGN_BENCH_TRACE
@@ -256,45 +608,53 @@ BenchmarkExecutor::runAlignment(AlignBenchOptions & options,
                                 TScore const & scoreMat)
 {
     options.stats.isBanded = "no";
+    mCells = countCells(options, execPolicy, set1, set2);
     switch (options.method)
     {
         case AlignMethod::GLOBAL:
         {
             resize(options.stats.scores, length(set1), Exact());
-            start(mTimer);
-            auto res = globalAlignmentScore(execPolicy, set1, set2, scoreMat);
-            stop(mTimer);
+            auto res = run(options, execPolicy, set1, set2, [&] (auto const & policy, auto & setH, auto & setV)
+            {
+                return globalAlignmentScore(policy, setH, setV, scoreMat);
+            });
             seqan::arrayMoveForward(begin(res, Standard()), end(res, Standard()), begin(options.stats.scores, Standard()));
             break;
         }
         case AlignMethod::LOCAL:
         {
             resize(options.stats.scores, length(set1), Exact());
-            start(mTimer);
-            auto res = localAlignmentScore(execPolicy, set1, set2, scoreMat);
-            stop(mTimer);
+            auto res = run(options, execPolicy, set1, set2, [&] (auto const & policy, auto & setH, auto & setV)
+            {
+                return localAlignmentScore(policy, setH, setV, scoreMat);
+            });
             seqan::arrayMoveForward(begin(res, Standard()), end(res, Standard()), begin(options.stats.scores, Standard()));
             break;
         }
         case AlignMethod::SEMIGLOBAL:
         {
             resize(options.stats.scores, length(set1), Exact());
-            start(mTimer);
-            auto res = globalAlignmentScore(execPolicy, set1, set2, scoreMat, AlignConfig<true, false, false, true>{});
-            stop(mTimer);
+            auto res = run(options, execPolicy, set1, set2, [&] (auto const & policy, auto & setH, auto & setV)
+            {
+                return globalAlignmentScore(policy, setH, setV, scoreMat, AlignConfig<true, false, false, true>{});
+            });
             seqan::arrayMoveForward(begin(res, Standard()), end(res, Standard()), begin(options.stats.scores, Standard()));
             break;
         }
         case AlignMethod::OVERLAP:
         {
             resize(options.stats.scores, length(set1), Exact());
-            start(mTimer);
-            auto res = globalAlignmentScore(execPolicy, set1, set2, scoreMat, AlignConfig<true, true, true, true>{});
-            stop(mTimer);
+            auto res = run(options, execPolicy, set1, set2, [&] (auto const & policy, auto & setH, auto & setV)
+            {
+                return globalAlignmentScore(policy, setH, setV, scoreMat, AlignConfig<true, true, true, true>{});
+            });
             seqan::arrayMoveForward(begin(res, Standard()), end(res, Standard()), begin(options.stats.scores, Standard()));
             break;
         }
     }
+    mPhases.add(Phase::DP, kernelTime());
+
+    ScopedPhase outputPhase(mPhases, Phase::OUTPUT);
     writeScores(options);
 }
 
@@ -306,50 +666,58 @@ template <typename TExecPolicy,
 inline void
 BenchmarkExecutor::runAlignmentBanded(AlignBenchOptions & options,
                                       TExecPolicy const & execPolicy,
-                                      TSet1 const & set1,
-                                      TSet2 const & set2,
+                                      TSet1 & set1,
+                                      TSet2 & set2,
                                       TScore const & scoreMat)
 {
     options.stats.isBanded = "yes";
+    mCells = countCells(options, execPolicy, set1, set2);
     switch (options.method)
     {
         case AlignMethod::GLOBAL:
         {
             resize(options.stats.scores, length(set1), Exact());
-            start(mTimer);
-            auto res = globalAlignmentScore(execPolicy, set1, set2, scoreMat, options.lower, options.upper);
-            stop(mTimer);
+            auto res = run(options, execPolicy, set1, set2, [&] (auto const & policy, auto & setH, auto & setV)
+            {
+                return globalAlignmentScore(policy, setH, setV, scoreMat, options.lower, options.upper);
+            });
             seqan::arrayMoveForward(begin(res, Standard()), end(res, Standard()), begin(options.stats.scores, Standard()));
             break;
         }
         case AlignMethod::LOCAL:
         {
             resize(options.stats.scores, length(set1), Exact());
-            start(mTimer);
-            auto res = localAlignmentScore(execPolicy, set1, set2, scoreMat, options.lower, options.upper);
-            stop(mTimer);
+            auto res = run(options, execPolicy, set1, set2, [&] (auto const & policy, auto & setH, auto & setV)
+            {
+                return localAlignmentScore(policy, setH, setV, scoreMat, options.lower, options.upper);
+            });
             seqan::arrayMoveForward(begin(res, Standard()), end(res, Standard()), begin(options.stats.scores, Standard()));
             break;
         }
         case AlignMethod::SEMIGLOBAL:
         {
             resize(options.stats.scores, length(set1), Exact());
-            start(mTimer);
-            auto res = globalAlignmentScore(execPolicy, set1, set2, scoreMat, AlignConfig<true, false, false, true>{}, options.lower, options.upper);
-            stop(mTimer);
+            auto res = run(options, execPolicy, set1, set2, [&] (auto const & policy, auto & setH, auto & setV)
+            {
+                return globalAlignmentScore(policy, setH, setV, scoreMat, AlignConfig<true, false, false, true>{}, options.lower, options.upper);
+            });
             seqan::arrayMoveForward(begin(res, Standard()), end(res, Standard()), begin(options.stats.scores, Standard()));
             break;
         }
         case AlignMethod::OVERLAP:
         {
             resize(options.stats.scores, length(set1), Exact());
-            start(mTimer);
-            auto res = globalAlignmentScore(execPolicy, set1, set2, scoreMat, AlignConfig<true, true, true, true>{}, options.lower, options.upper);
-            stop(mTimer);
+            auto res = run(options, execPolicy, set1, set2, [&] (auto const & policy, auto & setH, auto & setV)
+            {
+                return globalAlignmentScore(policy, setH, setV, scoreMat, AlignConfig<true, true, true, true>{}, options.lower, options.upper);
+            });
             seqan::arrayMoveForward(begin(res, Standard()), end(res, Standard()), begin(options.stats.scores, Standard()));
             break;
         }
     }
+    mPhases.add(Phase::DP, kernelTime());
+
+    ScopedPhase outputPhase(mPhases, Phase::OUTPUT);
     writeScores(options);
 }
 #endif // ALIGN_BENCH_BANDED
@@ -0,0 +1,484 @@
+//#define SEQAN_ALIGN_SIMD_PROFILE 1
+//#define SEQAN_ENABLE_TESTING 0
+//#define SEQAN_ENABLE_DEBUG 0
+
+//#define DP_PARALLEL_SHOW_PROGRESS
+//#define DP_ALIGN_STATS
+
+#define ALIGN_BENCH_BANDED
+
+#ifdef DP_ALIGN_STATS
+std::atomic<uint32_t> simdCounter;
+std::atomic<uint32_t> serialCounter;
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "align_bench_parser.hpp"
+#include "align_bench_configure.hpp"
+#include "align_bench_options.hpp"
+
+using namespace seqan;
+
+// ----------------------------------------------------------------------------
+// Class SweepDataset
+// ----------------------------------------------------------------------------
+
+// Either a simulated data set, a pair of input files or a data set of the benchmark suite.
+struct SweepDataset
+{
+    int                     numSequences{-1};
+    unsigned                minSize{0};
+    unsigned                maxSize{0};
+    std::string             pdf{"uniform"};
+    double                  identity{-1.0};  // Negative for independent sets.
+    std::string             queryFile;
+    std::string             databaseFile;
+    std::string             suite;  // Name of a data set of the benchmark suite.
+};
+
+// ----------------------------------------------------------------------------
+// Class SweepSpec
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class SweepSpec
+ * @brief Parameter space of a sweep.
+ *
+ * A sweep specification is a text file with one <tt>key = values</tt> pair per line. Lines starting with
+ * <tt>#</tt> are ignored. All combinations of the listed values are executed for every data set.
+ *
+ * @code{.txt}
+ * output        = sweep.csv
+ * repetition    = 3
+ * warmup        = 1
+ * alphabet      = dna
+ * method        = global
+ * mode          = pair
+ * seed          = 42
+ * dataset       = simulate 1000 1000 1100 uniform
+ * dataset       = simulate 1000 1000 1100 uniform 0.9
+ * dataset       = files query.fa db.fa
+ * dataset       = suite hifi-10k
+ * dataset-dir   = datasets
+ * policy        = seq seq_vec par par_vec wave wave_vec wave_opt_vec
+ * threads       = 1 2 4 8
+ * block-size    = 50 100 200
+ * jobs          = 16
+ * integer-width = 16 32
+ * @endcode
+ */
+struct SweepSpec
+{
+    std::string                 output{"align_bench_sweep.csv"};
+    std::string                 scoresOutput;
+    unsigned                    rep{1};
+    unsigned                    warmup{0};
+    uint32_t                    seed{std::numeric_limits<uint32_t>::max()};
+    std::string                 alphabet{"dna"};
+    std::string                 method{"global"};
+    std::string                 mode{"pair"};
+    bool                        sortSequences{false};
+    bool                        packed{false};
+    bool                        isBanded{false};
+    int                         lower{0};
+    int                         upper{0};
+    std::vector<SweepDataset>   datasets;
+    std::string                 datasetDir{defaultDatasetDir()};
+    std::vector<std::string>    policies{"seq"};
+    std::vector<unsigned>       threads{defaultThreadCount()};
+    std::vector<unsigned>       blockSizes{100};
+    std::vector<unsigned>       jobs{1};
+    std::vector<std::string>    widths{"32"};
+};
+
+// ----------------------------------------------------------------------------
+// Function readSweepSpec()
+// ----------------------------------------------------------------------------
+
+inline bool
+readSweepSpec(SweepSpec & spec, std::string const & fileName)
+{
+    std::ifstream specFile(fileName);
+    if (!specFile.good())
+    {
+        std::cerr << "Could not open sweep specification << " << fileName << ">>!" << std::endl;
+        return false;
+    }
+
+    auto readValues = [](std::istringstream & stream, auto & values)
+    {
+        values.clear();
+        typename std::decay_t<decltype(values)>::value_type value;
+        while (stream >> value)
+            values.push_back(value);
+        return !values.empty();
+    };
+
+    std::string line;
+    for (unsigned lineNo = 1; std::getline(specFile, line); ++lineNo)
+    {
+        line = line.substr(0, line.find('#'));
+        size_t delim = line.find('=');
+        if (delim == std::string::npos)
+        {
+            if (line.find_first_not_of(" \t\r") != std::string::npos)
+            {
+                std::cerr << fileName << ":" << lineNo << ": Expected 'key = values'." << std::endl;
+                return false;
+            }
+            continue;
+        }
+
+        std::istringstream keyStream(line.substr(0, delim));
+        std::istringstream values(line.substr(delim + 1));
+        std::string key;
+        keyStream >> key;
+
+        bool ok = true;
+        if (key == "output")
+            ok = static_cast<bool>(values >> spec.output);
+        else if (key == "scores-output")
+            ok = static_cast<bool>(values >> spec.scoresOutput);
+        else if (key == "repetition")
+            ok = static_cast<bool>(values >> spec.rep);
+        else if (key == "warmup")
+            ok = static_cast<bool>(values >> spec.warmup);
+        else if (key == "seed")
+            ok = static_cast<bool>(values >> spec.seed);
+        else if (key == "alphabet")
+            ok = static_cast<bool>(values >> spec.alphabet) && (spec.alphabet == "dna" || spec.alphabet == "aa");
+        else if (key == "method")
+            ok = static_cast<bool>(values >> spec.method) &&
+                 (spec.method == "global" || spec.method == "semi" || spec.method == "overlap" ||
+                  spec.method == "local");
+        else if (key == "mode")
+            ok = static_cast<bool>(values >> spec.mode) &&
+                 (spec.mode == "pair" || spec.mode == "search" || spec.mode == "olc");
+        else if (key == "sort-sequences")
+            ok = static_cast<bool>(values >> spec.sortSequences);
+        else if (key == "packed")
+            ok = static_cast<bool>(values >> spec.packed);
+        else if (key == "band")
+            ok = spec.isBanded = static_cast<bool>(values >> spec.lower >> spec.upper);
+        else if (key == "policy")
+            ok = readValues(values, spec.policies);
+        else if (key == "threads")
+            ok = readValues(values, spec.threads);
+        else if (key == "block-size")
+            ok = readValues(values, spec.blockSizes);
+        else if (key == "jobs")
+            ok = readValues(values, spec.jobs);
+        else if (key == "integer-width")
+            ok = readValues(values, spec.widths) &&
+                 std::all_of(spec.widths.begin(), spec.widths.end(), [] (std::string const & width)
+                 {
+                     return width == "8" || width == "16" || width == "32" || width == "64";
+                 });
+        else if (key == "dataset-dir")
+            ok = static_cast<bool>(values >> spec.datasetDir);
+        else if (key == "dataset")
+        {
+            SweepDataset dataset;
+            std::string kind;
+            values >> kind;
+            if (kind == "simulate")
+            {
+                ok = static_cast<bool>(values >> dataset.numSequences >> dataset.minSize >> dataset.maxSize);
+                values >> dataset.pdf >> dataset.identity;
+            }
+            else if (kind == "files")
+            {
+                ok = static_cast<bool>(values >> dataset.queryFile >> dataset.databaseFile);
+            }
+            else if (kind == "suite")
+            {
+                ok = static_cast<bool>(values >> dataset.suite) && findBenchmarkDataset(dataset.suite) != nullptr;
+            }
+            else
+            {
+                ok = false;
+            }
+            spec.datasets.push_back(dataset);
+        }
+        else
+        {
+            std::cerr << fileName << ":" << lineNo << ": Unknown key '" << key << "'." << std::endl;
+            return false;
+        }
+
+        if (!ok)
+        {
+            std::cerr << fileName << ":" << lineNo << ": Invalid value for '" << key << "'." << std::endl;
+            return false;
+        }
+    }
+
+    if (spec.datasets.empty())
+    {
+        std::cerr << fileName << ": No dataset specified." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// Function runConfiguration()
+// ----------------------------------------------------------------------------
+
+template <typename TExecPolicy>
+inline void
+setParallelism(AlignBenchOptions const & options, TExecPolicy & execPolicy)
+{
+    setNumThreads(execPolicy, options.threadCount);
+}
+
+template <typename TWaveSpec, typename TVectorSpec>
+inline void
+setParallelism(AlignBenchOptions const & options,
+               seqan::ExecutionPolicy<seqan::WavefrontAlignment<TWaveSpec>, TVectorSpec> & execPolicy)
+{
+    setNumThreads(execPolicy, options.threadCount);
+    setParallelAlignments(execPolicy, options.parallelInstances);
+    setBlockSize(execPolicy, options.blockSize);
+}
+
+template <typename TExecPolicy, typename TAlphabet, typename TStringSpec>
+inline void
+runConfiguration(AlignBenchOptions & options, Workload<TAlphabet, TStringSpec> & workload)
+{
+    TExecPolicy execPolicy;
+    setParallelism(options, execPolicy);
+    configureScoreWidth(options, workload, execPolicy);
+}
+
+// Returns false if the policy is not available in this build.
+template <typename TAlphabet, typename TStringSpec>
+inline bool
+runPolicy(AlignBenchOptions & options, Workload<TAlphabet, TStringSpec> & workload, std::string const & policy)
+{
+    options.stats.execPolicy = policy;
+    if (policy == "seq")
+    {
+        options.stats.execPolicy = "sequential";
+        runConfiguration<seqan::ExecutionPolicy<seqan::Serial, seqan::Serial>>(options, workload);
+    }
+    else if (policy == "par")
+    {
+        options.stats.execPolicy = "parallel";
+        runConfiguration<seqan::ExecutionPolicy<seqan::Parallel, seqan::Serial>>(options, workload);
+    }
+    else if (policy == "wave")
+    {
+        runConfiguration<seqan::ExecutionPolicy<seqan::WavefrontAlignment<>, seqan::Serial>>(options, workload);
+    }
+#if defined(SEQAN_SIMD_ENABLED)
+    else if (policy == "seq_vec")
+    {
+        options.stats.execPolicy = "sequential_vec";
+        runConfiguration<seqan::ExecutionPolicy<seqan::Serial, seqan::Vectorial>>(options, workload);
+    }
+    else if (policy == "par_vec")
+    {
+        options.stats.execPolicy = "parallel_vec";
+        runConfiguration<seqan::ExecutionPolicy<seqan::Parallel, seqan::Vectorial>>(options, workload);
+    }
+    else if (policy == "wave_vec")
+    {
+        runConfiguration<seqan::ExecutionPolicy<seqan::WavefrontAlignment<>, seqan::Vectorial>>(options, workload);
+    }
+    else if (policy == "wave_opt_vec")
+    {
+        runConfiguration<seqan::ExecutionPolicy<seqan::WavefrontAlignment<BlockOffsetOptimization>,
+                                                seqan::Vectorial>>(options, workload);
+    }
+#endif  // defined(SEQAN_SIMD_ENABLED)
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// Function sweepDataset()
+// ----------------------------------------------------------------------------
+
+template <typename TAlphabet, typename TStringSpec>
+inline void
+sweepDataset(AlignBenchOptions & options, SweepSpec const & spec, std::ostream & out)
+{
+    // The data set is loaded once and shared by all configurations.
+    Workload<TAlphabet, TStringSpec> workload;
+    if (!loadWorkload(options, workload))
+        return;
+
+    AlignBenchStats const datasetStats = options.stats;
+
+    // Widths without a score configuration in this build are reported once instead of writing rows for them.
+    std::vector<std::string> widths;
+    for (auto const & width : spec.widths)
+    {
+        if (isIntegerWidthAvailable(width))
+            widths.push_back(width);
+        else
+            std::cerr << "Integer width " << width << " is not available in this build." << std::endl;
+    }
+
+    for (auto const & policy : spec.policies)
+    {
+        bool isParallel = policy.compare(0, 3, "par") == 0 || policy.compare(0, 4, "wave") == 0;
+        bool isWave = policy.compare(0, 4, "wave") == 0;
+        bool isVectorized = policy.find("_vec") != std::string::npos;
+
+        for (unsigned threads : (isParallel) ? spec.threads : std::vector<unsigned>{1})
+        {
+            for (unsigned blockSize : (isWave) ? spec.blockSizes : std::vector<unsigned>{0})
+            {
+                for (unsigned jobs : (isWave) ? spec.jobs : std::vector<unsigned>{0})
+                {
+                    for (auto const & width : widths)
+                    {
+                        options.stats = datasetStats;
+                        options.threadCount = threads;
+                        options.blockSize = blockSize;
+                        options.parallelInstances = jobs;
+                        setIntegerWidth(options, width);
+
+                        options.stats.threads = threads;
+                        options.stats.blockSize = blockSize;
+                        options.stats.parallelInstances = jobs;
+                        options.stats.vectorLength = (isVectorized)
+                            ? SEQAN_SIZEOF_MAX_VECTOR / static_cast<unsigned>(options.simdWidth) : 0;
+
+                        std::cout << "\nConfiguration: " << policy << " threads=" << threads << " block-size="
+                                  << blockSize << " jobs=" << jobs << " integer-width=" << width << std::endl;
+
+                        if (!runPolicy(options, workload, policy))
+                        {
+                            std::cerr << "Policy " << policy << " is not available in this build." << std::endl;
+                            continue;
+                        }
+
+                        options.stats.state = "done";
+                        options.stats.writeStats(out);
+                        out.flush();
+                    }
+                }
+            }
+        }
+    }
+}
+
+/*
+ * @fn parsCommandLine
+ *
+ * @brief Parses the command line arguments and options.
+ *
+ * @signature ParseResult parseCommandLine(spec, argc, argv)
+ * @param   spec    The @link SweepSpec @endlink to be created.
+ * @param   argc    The number of input arguments. Of type <tt>int</tt>
+ * @param   argv    The argument values. Of type <tt>char **</tt>.
+ *
+ * @return ParseResult PARSE_OK on success, otherwise PARSE_ERROR.
+ */
+inline ArgumentParser::ParseResult
+parseCommandLine(SweepSpec & spec, int const argc, char* argv[])
+{
+    ArgumentParser parser("align_bench_sweep");
+
+    setShortDescription(parser, "Alignment Benchmark Parameter Sweep");
+    setVersion(parser, SEQAN_APP_VERSION " [" SEQAN_REVISION "]");
+    setDate(parser, SEQAN_DATE);
+
+    addArgument(parser, ArgParseArgument(ArgParseArgument::INPUT_FILE, "SPEC"));
+
+    addOption(parser, seqan::ArgParseOption("o", "output", "Overrides the stats file of the specification.", seqan::ArgParseArgument::OUTPUT_FILE, "OUT"));
+
+    // Parse command line.
+    if (parse(parser, argc, argv) != ArgumentParser::PARSE_OK)
+        return ArgumentParser::PARSE_ERROR;
+
+    std::string specFile;
+    getArgumentValue(specFile, parser, 0);
+    if (!readSweepSpec(spec, specFile))
+        return ArgumentParser::PARSE_ERROR;
+
+    getOptionValue(spec.output, parser, "o");
+
+    return ArgumentParser::PARSE_OK;
+}
+
+int main(int argc, char* argv[])
+{
+    SweepSpec spec;
+
+    if (parseCommandLine(spec, argc, argv) != ArgumentParser::PARSE_OK)
+        return EXIT_FAILURE;
+
+// TODO(rrahn): Make object configurable.
+#ifdef DP_ALIGN_STATS
+    simdCounter = 0;
+    serialCounter = 0;
+#endif
+
+    std::ofstream out(spec.output.c_str());
+    if (!out.good())
+    {
+        std::cerr << "Could not open file << " << spec.output << ">>!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    AlignBenchOptions base;
+    base.alignOut = spec.scoresOutput;
+    base.rep = spec.rep;
+    base.warmup = spec.warmup;
+    base.seed = spec.seed;
+    base.sortSequences = spec.sortSequences;
+    base.packed = spec.packed;
+    base.stats.storage = (spec.packed) ? "packed" : "plain";
+    base.isBanded = spec.isBanded;
+    base.lower = spec.lower;
+    base.upper = spec.upper;
+    setAlphabet(base, spec.alphabet);
+    setMethod(base, spec.method);
+    setAlignmentMode(base, spec.mode);
+
+    base.stats.writeHeader(out);
+    for (auto const & dataset : spec.datasets)
+    {
+        AlignBenchOptions options = base;
+        options.numSequences = dataset.numSequences;
+        options.minSize = dataset.minSize;
+        options.maxSize = dataset.maxSize;
+        setDistribution(options, dataset.pdf);
+        if (dataset.identity >= 0.0)
+            setMutationIdentity(options.mutation, dataset.identity);
+        options.queryFile = dataset.queryFile;
+        options.databaseFile = dataset.databaseFile;
+        if (!dataset.suite.empty())
+            setDataset(options, *findBenchmarkDataset(dataset.suite), spec.datasetDir);
+
+        if (options.alpha == ScoreAlphabet::DNA)
+        {
+            options.stats.scoreAlpha = "dna";
+            if (options.packed)
+                sweepDataset<Dna5, Packed<>>(options, spec, out);
+            else
+                sweepDataset<Dna5, Alloc<>>(options, spec, out);
+        }
+        else
+        {
+            options.stats.scoreAlpha = "aa";
+            if (options.packed)
+                sweepDataset<AminoAcid, Packed<>>(options, spec, out);
+            else
+                sweepDataset<AminoAcid, Alloc<>>(options, spec, out);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
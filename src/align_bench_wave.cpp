@@ -40,7 +40,10 @@ parseCommandLine(AlignBenchOptions & options, int const argc, char* argv[])
     setup_parser(parser);
 
     addOption(parser, seqan::ArgParseOption("t", "threads", "Number of threads", seqan::ArgParseArgument::INTEGER, "INT"));
-    setDefaultValue(parser, "t", toString(std::thread::hardware_concurrency()));
+    setDefaultValue(parser, "t", toString(defaultThreadCount()));
+
+    addOption(parser, seqan::ArgParseOption("", "scaling", "Runs the workload with 1, 2, 4, ... up to the given number of threads and reports speedup, efficiency and Karp-Flatt metric. For weak scaling the workload grows with the number of threads.", seqan::ArgParseArgument::STRING, "STRING"));
+    setValidValues(parser, "scaling", "strong weak");
 
     addOption(parser, seqan::ArgParseOption("", "jobs", "Number of parallel alignment instances", seqan::ArgParseArgument::INTEGER, "INT"));
     setMinValue(parser, "jobs", "1");
@@ -58,6 +61,12 @@ parseCommandLine(AlignBenchOptions & options, int const argc, char* argv[])
     get_arguments(options, parser);
 
     getOptionValue(options.threadCount, parser, "t");
+    if (options.threadCount == 0)
+        options.threadCount = defaultThreadCount();
+
+    std::string scaling;
+    if (getOptionValue(scaling, parser, "scaling"))
+        setScalingMode(options, scaling);
     getOptionValue(options.parallelInstances, parser, "jobs");
     getOptionValue(options.blockSize, parser, "block-size");
     options.blockOptimization = isSet(parser, "block-offset");
@@ -65,6 +74,40 @@ parseCommandLine(AlignBenchOptions & options, int const argc, char* argv[])
     return ArgumentParser::PARSE_OK;
 }
 
+// ----------------------------------------------------------------------------
+// Function run()
+// ----------------------------------------------------------------------------
+
+// Configures the execution policy from the options and runs the benchmark, or a scaling series of it.
+template <typename TExecPolicy>
+inline void
+run(AlignBenchOptions & options)
+{
+    auto makePolicy = [] (AlignBenchOptions const & runOptions)
+    {
+        TExecPolicy exec_policy;
+        setNumThreads(exec_policy, runOptions.threadCount);
+        setParallelAlignments(exec_policy, runOptions.parallelInstances);
+        setBlockSize(exec_policy, runOptions.blockSize);
+        return exec_policy;
+    };
+
+    if (options.scaling != ScalingMode::NONE)
+    {
+        configureScaling(options, [&] (AlignBenchOptions & runOptions, auto & workload)
+        {
+            configureScoreWidth(runOptions, workload, makePolicy(runOptions));
+        }, std::cout);
+        return;
+    }
+
+    configureAlpha(options, makePolicy(options));
+
+    options.stats.state = "done";
+    options.stats.writeHeader(std::cout);
+    options.stats.writeStats(std::cout);
+}
+
 int main(int argc, char* argv[])
 {
     AlignBenchOptions options;
@@ -86,35 +129,19 @@ int main(int argc, char* argv[])
         if (options.blockOptimization)
         {
             options.stats.execPolicy = "wave_opt_vec";
-            seqan::ExecutionPolicy<seqan::WavefrontAlignment<BlockOffsetOptimization>, seqan::Vectorial> exec_policy;
-            setNumThreads(exec_policy, options.threadCount);
-            setParallelAlignments(exec_policy, options.parallelInstances);
-            setBlockSize(exec_policy, options.blockSize);
-            configureAlpha(options, exec_policy);
+            run<seqan::ExecutionPolicy<seqan::WavefrontAlignment<BlockOffsetOptimization>, seqan::Vectorial>>(options);
         }
         else
         {
             options.stats.execPolicy = "wave_vec";
-            seqan::ExecutionPolicy<seqan::WavefrontAlignment<>, seqan::Vectorial> exec_policy;
-            setNumThreads(exec_policy, options.threadCount);
-            setParallelAlignments(exec_policy, options.parallelInstances);
-            setBlockSize(exec_policy, options.blockSize);
-            configureAlpha(options, exec_policy);
+            run<seqan::ExecutionPolicy<seqan::WavefrontAlignment<>, seqan::Vectorial>>(options);
         }
     }
     else
     {
         options.stats.execPolicy = "wave";
-        seqan::ExecutionPolicy<seqan::WavefrontAlignment<>, seqan::Serial> exec_policy;
-        setNumThreads(exec_policy, options.threadCount);
-        setParallelAlignments(exec_policy, options.parallelInstances);
-        setBlockSize(exec_policy, options.blockSize);
-        configureAlpha(options, exec_policy);
+        run<seqan::ExecutionPolicy<seqan::WavefrontAlignment<>, seqan::Serial>>(options);
     }
 
-    options.stats.state = "done";
-    options.stats.writeHeader(std::cout);
-    options.stats.writeStats(std::cout);
-
     return EXIT_SUCCESS;
 }
@@ -35,7 +35,48 @@
 #ifndef BENCHMARK_EXECUTOR_HPP_
 #define BENCHMARK_EXECUTOR_HPP_
 
+#include <unistd.h>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
 #include "timer.hpp"
+#include "perf_counters.hpp"
+#include "latency_histogram.hpp"
+#include "memory_stats.hpp"
+#include "phase_timer.hpp"
+#include "rapl_energy.hpp"
+#include "cell_accounting.hpp"
+#include "pair_space.hpp"
+
+// ----------------------------------------------------------------------------
+// Function pairBatchSize()
+// ----------------------------------------------------------------------------
+
+// Number of pairs aligned at once. Materialized sets are aligned as a whole.
+template <typename TSet>
+inline size_t
+pairBatchSize(AlignBenchOptions const & /*options*/, TSet const & set)
+{
+    return std::max<size_t>(length(set), 1);
+}
+
+// The pairs of the search and OLC modes are aligned in batches of options.pairBatch pairs, rounded up to a multiple
+// of the vector length, such that the SIMD engines fill their vectors with the same pairs as without batching. The
+// pairs of the pair mode are the records themselves and, like all pairs if options.pairBatch is 0, aligned at once.
+template <typename TView>
+inline size_t
+pairBatchSize(AlignBenchOptions const & options, LazyPairSet<TView> const & set)
+{
+    if (options.pairBatch == 0 || set.space().mode() == AlignmentMode::PAIR)
+        return std::max<size_t>(length(set), 1);
+
+    size_t const lanes = std::max<size_t>(options.stats.vectorLength, 1);
+    return (options.pairBatch + lanes - 1) / lanes * lanes;
+}
 
 // ----------------------------------------------------------------------------
 // Class BenchmarkExecutor
@@ -114,9 +155,266 @@ public:
         return getValue(mTimer);
     }
 
+    inline auto const &
+    getRunTimes()
+    {
+        return getRuns(mTimer);
+    }
+
+    inline auto const &
+    getPerfCounterValues()
+    {
+        return mPerfValues;
+    }
+
+    inline MemoryStats
+    getMemoryStats()
+    {
+        return mMemoryProbe.getStats();
+    }
+
+    inline CellCounts const &
+    getCellCounts()
+    {
+        return mCells;
+    }
+
+    inline EnergyStats
+    getEnergyStats()
+    {
+        return mEnergyProbe.getStats();
+    }
+
+    inline PhaseProfile const &
+    getPhases()
+    {
+        return mPhases;
+    }
+
+    // Returns true if the latencies were recorded by aligning the chunks with another policy than the configured one.
+    inline bool
+    isLatencyChunked() const
+    {
+        return mLatencyChunked;
+    }
+
+    inline LatencyStats
+    getLatencyStats()
+    {
+        if (mLatencyHistogram.count() == 0)
+            return LatencyStats{};
+        return computeLatencyStats(mLatencyHistogram);
+    }
+
 private:
 
-    Timer<double>   mTimer;
+    /*!
+     * @fn BenchmarkExecutor#run
+     * @brief Measures <tt>func(execPolicy, set1, set2)</tt>.
+     *
+     * If <tt>options.latency</tt> is set, the alignments are issued in chunks by
+     * @link BenchmarkExecutor#runInstrumented @endlink to record the completion latency of every alignment.
+     */
+    template <typename TExecPolicy, typename TSet1, typename TSet2, typename TFunc>
+    inline auto
+    run(AlignBenchOptions const & options,
+        TExecPolicy const & execPolicy,
+        TSet1 & set1,
+        TSet2 & set2,
+        TFunc && func)
+    {
+        if (options.latency)
+            return measure(options, [&] () { return runInstrumented(options, execPolicy, set1, set2, func); });
+
+        return measure(options, [&] () { return func(execPolicy, set1, set2); });
+    }
+
+    // Alignments whose pairs are computed on demand are materialized once before the passes if they are aligned at
+    // once, see pairBatchSize(), and otherwise in batches within every pass, see
+    // @link BenchmarkExecutor#runBatches @endlink. The time of materializing the batches is accounted to the pairs
+    // phase instead of the kernel, see kernelTime().
+    template <typename TExecPolicy, typename TView, typename TFunc>
+    inline auto
+    run(AlignBenchOptions const & options,
+        TExecPolicy const & execPolicy,
+        LazyPairSet<TView> & set1,
+        LazyPairSet<TView> & set2,
+        TFunc && func)
+    {
+        if (pairBatchSize(options, set1) >= length(set1))
+        {
+            StringSet<TView> setH;
+            StringSet<TView> setV;
+            {
+                ScopedPhase pairsPhase(mPhases, Phase::PAIRS);
+                materialize(setH, set1, 0, length(set1));
+                materialize(setV, set2, 0, length(set2));
+            }
+            return run(options, execPolicy, setH, setV, func);
+        }
+
+        double pairsTime = 0.0;
+        unsigned passes = 0;
+        auto res = measure(options, [&] ()
+        {
+            ++passes;
+            return runBatches(options, execPolicy, set1, set2, pairsTime, func);
+        });
+        addBatchPairsTime(pairsTime / passes);
+        return res;
+    }
+
+    template <typename TExecPolicy, typename TView, typename TFunc>
+    inline auto
+    runBatches(AlignBenchOptions const &,
+               TExecPolicy const &,
+               LazyPairSet<TView> const &,
+               LazyPairSet<TView> const &,
+               double &,
+               TFunc &&);
+
+    // Accounts the mean time per pass spent on building the pairs of the batches inside the timed passes.
+    inline void
+    addBatchPairsTime(double const seconds)
+    {
+        mBatchPairsTime = seconds;
+        mPhases.add(Phase::PAIRS, seconds);
+    }
+
+    // The mean time of a timed pass without building the pairs of the batches.
+    inline double
+    kernelTime()
+    {
+        return std::max(getTime() - mBatchPairsTime, 0.0);
+    }
+
+    template <typename TExecPolicy, typename TSet1, typename TSet2, typename TFunc>
+    inline auto
+    runInstrumented(AlignBenchOptions const &,
+                    TExecPolicy const &,
+                    TSet1 &,
+                    TSet2 &,
+                    TFunc &&);
+
+#if defined(ALIGN_BENCH_TRACE)
+    template <typename TExecPolicy, typename TSet1, typename TSet2, typename TScore>
+    inline double
+    measureScorePass(AlignBenchOptions const &,
+                     TExecPolicy const &,
+                     TSet1 &,
+                     TSet2 &,
+                     TScore const &);
+
+    template <typename TExecPolicy, typename TSet1, typename TSet2, typename TFunc>
+    inline void
+    runTrace(AlignBenchOptions &,
+             TExecPolicy const &,
+             TSet1 &,
+             TSet2 &,
+             double const,
+             TFunc &&);
+#endif // ALIGN_BENCH_TRACE
+
+    /*!
+     * @fn BenchmarkExecutor#measure
+     * @brief Runs <tt>options.warmup</tt> untimed passes of <tt>func</tt> followed by <tt>options.rep</tt> timed
+     * passes and returns the result of the last timed pass.
+     *
+     * If <tt>options.flushCache</tt> is set, the last-level cache is evicted before every pass.
+     * If <tt>options.hwCounters</tt> is set, the hardware events of the timed passes are recorded.
+     * The memory and, if the RAPL counters are readable, the energy consumption of the timed passes are always
+     * sampled.
+     */
+    template <typename TFunc>
+    inline auto
+    measure(AlignBenchOptions const & options, TFunc && func)
+    {
+        // Open the counters before the first pass spawns the worker threads, such that they are inherited.
+        PerfCounters * counters = (options.hwCounters) ? &processPerfCounters() : nullptr;
+
+        for (unsigned i = 0; i < options.warmup; ++i)
+        {
+            if (options.flushCache)
+                flushCache();
+            func();
+        }
+
+        if (counters != nullptr)
+            counters->reset();
+
+        mLatencyHistogram.reset();
+        mMemoryProbe.reset();
+        mEnergyProbe.reset();
+        mBatchPairsTime = 0.0;
+        clear(mTimer);
+        decltype(func()) res;
+        for (unsigned i = 0; i < std::max(options.rep, 1u); ++i)
+        {
+            if (options.flushCache)
+                flushCache();
+            mMemoryProbe.start();
+            if (counters != nullptr)
+                counters->start();
+            mEnergyProbe.start();
+            start(mTimer);
+            res = func();
+            stop(mTimer);
+            mEnergyProbe.stop();
+            if (counters != nullptr)
+                counters->stop();
+            mMemoryProbe.stop();
+        }
+
+        if (counters != nullptr)
+            mPerfValues = counters->getValues(std::max(options.rep, 1u));
+        return res;
+    }
+
+    // Without a score-only pass (negative time) the DP phase includes the traceback.
+    inline void
+    addKernelPhases(double const scorePassTime)
+    {
+        if (scorePassTime < 0.0)
+        {
+            mPhases.add(Phase::DP, kernelTime());
+            return;
+        }
+        mPhases.add(Phase::DP, scorePassTime);
+        mPhases.add(Phase::TRACEBACK, std::max(kernelTime() - scorePassTime, 0.0));
+    }
+
+    // Streams through a buffer twice the size of the last-level cache to evict the data of the previous pass.
+    inline void
+    flushCache()
+    {
+        if (mFlushBuffer.empty())
+        {
+            long llcSize = 0;
+#if defined(_SC_LEVEL3_CACHE_SIZE)
+            llcSize = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+            mFlushBuffer.resize(std::max<size_t>(2 * std::max(llcSize, 0l), 64 * 1024 * 1024));
+        }
+
+        for (size_t i = 0; i < mFlushBuffer.size(); i += 64)
+            ++mFlushBuffer[i];
+
+        volatile char sink = 0;
+        for (size_t i = 0; i < mFlushBuffer.size(); i += 64)
+            sink += mFlushBuffer[i];
+        (void)sink;
+    }
+
+    Timer<double>       mTimer;
+    PerfCounterValues   mPerfValues;
+    LatencyHistogram    mLatencyHistogram;
+    double              mBatchPairsTime{0.0};
+    bool                mLatencyChunked{false};
+    MemoryProbe         mMemoryProbe;
+    EnergyProbe         mEnergyProbe;
+    CellCounts          mCells;
+    PhaseProfile        mPhases;
+    std::vector<char>   mFlushBuffer;
 };
 
 #endif  // #ifndef BENCHMARK_EXECUTOR_HPP_
@@ -0,0 +1,126 @@
+// ==========================================================================
+//                 SeqAn - The Library for Sequence Analysis
+// ==========================================================================
+// Copyright (c) 2006-2018, Knut Reinert, FU Berlin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Knut Reinert or the FU Berlin nor the names of
+//       its contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Rene Rahn <rene.rahn@fu-berlin.de>
+// ==========================================================================
+
+#ifndef BOUNDED_QUEUE_HPP_
+#define BOUNDED_QUEUE_HPP_
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+// ----------------------------------------------------------------------------
+// Class BoundedQueue
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class BoundedQueue
+ * @headerfile bounded_queue.hpp
+ * @brief Blocking multi-producer/multi-consumer queue holding at most <tt>capacity</tt> elements.
+ *
+ * @signature template <typename TValue>
+ *            class BoundedQueue;
+ *
+ * Producers block in @link BoundedQueue#push @endlink while the queue is full, consumers block in
+ * @link BoundedQueue#pop @endlink while it is empty. After @link BoundedQueue#close @endlink the remaining elements
+ * are still handed out, further pushes are rejected and <tt>pop</tt> returns <tt>false</tt> once the queue ran empty.
+ */
+template <typename TValue>
+class BoundedQueue
+{
+public:
+
+    explicit BoundedQueue(size_t const capacity) : mCapacity(std::max<size_t>(capacity, 1))
+    {}
+
+    BoundedQueue(BoundedQueue const &) = delete;
+    BoundedQueue & operator=(BoundedQueue const &) = delete;
+
+    // Returns false if the queue was closed before the value could be enqueued.
+    inline bool push(TValue value)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mNotFull.wait(lock, [this] () { return mClosed || mQueue.size() < mCapacity; });
+        if (mClosed)
+            return false;
+
+        mQueue.push_back(std::move(value));
+        lock.unlock();
+        mNotEmpty.notify_one();
+        return true;
+    }
+
+    // Returns false if the queue is closed and empty.
+    inline bool pop(TValue & value)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mNotEmpty.wait(lock, [this] () { return mClosed || !mQueue.empty(); });
+        if (mQueue.empty())
+            return false;
+
+        value = std::move(mQueue.front());
+        mQueue.pop_front();
+        lock.unlock();
+        mNotFull.notify_one();
+        return true;
+    }
+
+    inline void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mClosed = true;
+        }
+        mNotEmpty.notify_all();
+        mNotFull.notify_all();
+    }
+
+    inline size_t capacity() const
+    {
+        return mCapacity;
+    }
+
+private:
+
+    size_t                  mCapacity;
+    bool                    mClosed{false};
+    std::deque<TValue>      mQueue;
+    std::mutex              mMutex;
+    std::condition_variable mNotEmpty;
+    std::condition_variable mNotFull;
+};
+
+#endif  // BOUNDED_QUEUE_HPP_
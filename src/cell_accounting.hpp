@@ -0,0 +1,215 @@
+// ==========================================================================
+//                 SeqAn - The Library for Sequence Analysis
+// ==========================================================================
+// Copyright (c) 2006-2018, Knut Reinert, FU Berlin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Knut Reinert or the FU Berlin nor the names of
+//       its contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Rene Rahn <rene.rahn@fu-berlin.de>
+// ==========================================================================
+
+#ifndef CELL_ACCOUNTING_HPP_
+#define CELL_ACCOUNTING_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include <seqan/basic.h>
+#include <seqan/align_parallel.h>
+#include <seqan/parallel.h>
+
+#include "align_bench_options.hpp"
+
+using namespace seqan;
+
+// ----------------------------------------------------------------------------
+// Class CellCounts
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class CellCounts
+ * @headerfile cell_accounting.hpp
+ * @brief Number of DP cells of a set of alignments.
+ *
+ * <tt>useful</tt> counts the cells within the band of every alignment, which is the whole matrix for unbanded
+ * alignments. <tt>computed</tt> additionally counts the cells an engine computes due to padding, e.g. the
+ * lanes of a SIMD vector that are filled up to the longest sequences of the vector.
+ */
+struct CellCounts
+{
+    double  useful{0};
+    double  computed{0};
+};
+
+// ============================================================================
+// Functions
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Function cellsBelowDiagonal()
+// ----------------------------------------------------------------------------
+
+// Number of cells (i, j) of a (1+lenV)x(1+lenH) matrix with j - i <= diagonal.
+inline int64_t cellsBelowDiagonal(int64_t const lenH, int64_t const lenV, int64_t const diagonal)
+{
+    if (diagonal < -lenV)
+        return 0;
+
+    // Columns up to the diagonal's start are complete.
+    int64_t const fullColumns = (diagonal >= 0) ? std::min(lenH, diagonal) + 1 : 0;
+    int64_t res = fullColumns * (lenV + 1);
+
+    // The remaining columns j lose j - diagonal cells at the top.
+    int64_t const first = std::max<int64_t>(0, diagonal + 1);
+    int64_t const last = std::min(lenH, diagonal + lenV);
+    if (last >= first)
+    {
+        int64_t const count = last - first + 1;
+        res += count * (lenV + diagonal + 1) - (first + last) * count / 2;
+    }
+    return res;
+}
+
+// ----------------------------------------------------------------------------
+// Function bandCells()
+// ----------------------------------------------------------------------------
+
+// Number of cells of the matrix between the lower and the upper diagonal, or of the whole matrix if unbanded.
+inline double bandCells(AlignBenchOptions const & options, size_t const lenH, size_t const lenV)
+{
+    if (!options.isBanded)
+        return static_cast<double>(1 + lenH) * (1 + lenV);
+
+    return static_cast<double>(cellsBelowDiagonal(lenH, lenV, options.upper) -
+                               cellsBelowDiagonal(lenH, lenV, static_cast<int64_t>(options.lower) - 1));
+}
+
+// ----------------------------------------------------------------------------
+// Function computedCells()
+// ----------------------------------------------------------------------------
+
+// Serial engines compute exactly the cells of the band.
+template <typename TParSpec, typename TSet1, typename TSet2>
+inline double computedCells(AlignBenchOptions const & /*options*/,
+                            ExecutionPolicy<TParSpec, Serial> const & /*execPolicy*/,
+                            TSet1 const & /*set1*/,
+                            TSet2 const & /*set2*/,
+                            double const useful)
+{
+    return useful;
+}
+
+// The inter-sequence SIMD engines align vectorLength consecutive pairs together. Every lane computes the matrix
+// of the longest sequences of its vector, and the lanes of the last vector are filled up as well.
+template <typename TParSpec, typename TSet1, typename TSet2>
+inline double computedCells(AlignBenchOptions const & options,
+                            ExecutionPolicy<TParSpec, Vectorial> const & /*execPolicy*/,
+                            TSet1 const & set1,
+                            TSet2 const & set2,
+                            double const /*useful*/)
+{
+    size_t const lanes = std::max<size_t>(options.stats.vectorLength, 1);
+    int64_t const numChunks = (length(set1) + lanes - 1) / lanes;
+    double res = 0;
+    SEQAN_OMP_PRAGMA(parallel for reduction(+ : res))
+    for (int64_t c = 0; c < numChunks; ++c)
+    {
+        size_t const chunk = c * lanes;
+        size_t maxH = 0;
+        size_t maxV = 0;
+        for (size_t i = chunk; i < std::min(chunk + lanes, static_cast<size_t>(length(set1))); ++i)
+        {
+            maxH = std::max<size_t>(maxH, length(set1[i]));
+            maxV = std::max<size_t>(maxV, length(set2[i]));
+        }
+        res += lanes * bandCells(options, maxH, maxV);
+    }
+    return res;
+}
+
+// The wavefront engine computes tiles of blockSize x blockSize cells. Serial tiles are trimmed at the matrix
+// borders, the vectorized engine computes full tiles in every lane.
+template <typename TWaveSpec, typename TSet1, typename TSet2>
+inline double computedCells(AlignBenchOptions const & /*options*/,
+                            ExecutionPolicy<WavefrontAlignment<TWaveSpec>, Serial> const & /*execPolicy*/,
+                            TSet1 const & /*set1*/,
+                            TSet2 const & /*set2*/,
+                            double const useful)
+{
+    return useful;
+}
+
+template <typename TWaveSpec, typename TSet1, typename TSet2>
+inline double computedCells(AlignBenchOptions const & options,
+                            ExecutionPolicy<WavefrontAlignment<TWaveSpec>, Vectorial> const & /*execPolicy*/,
+                            TSet1 const & set1,
+                            TSet2 const & set2,
+                            double const /*useful*/)
+{
+    double const blockSize = std::max(options.blockSize, 1u);
+    double res = 0;
+    SEQAN_OMP_PRAGMA(parallel for reduction(+ : res))
+    for (int64_t i = 0; i < static_cast<int64_t>(length(set1)); ++i)
+    {
+        double const tilesH = std::ceil((1 + length(set1[i])) / blockSize);
+        double const tilesV = std::ceil((1 + length(set2[i])) / blockSize);
+        res += tilesH * tilesV * blockSize * blockSize;
+    }
+    return res;
+}
+
+// ----------------------------------------------------------------------------
+// Function countCells()
+// ----------------------------------------------------------------------------
+
+/*!
+ * @fn countCells
+ * @brief Counts the useful and computed cells of aligning <tt>set1[i]</tt> with <tt>set2[i]</tt>.
+ *
+ * @signature CellCounts countCells(options, execPolicy, set1, set2)
+ *
+ * The band is taken from <tt>options</tt>, the padding depends on the engine selected by <tt>execPolicy</tt>.
+ * The pairs are counted in parallel, since the sets of the <i>search</i> and <i>OLC</i> modes might be huge.
+ */
+template <typename TExecPolicy, typename TSet1, typename TSet2>
+inline CellCounts countCells(AlignBenchOptions const & options,
+                             TExecPolicy const & execPolicy,
+                             TSet1 const & set1,
+                             TSet2 const & set2)
+{
+    CellCounts res;
+    double useful = 0;
+    SEQAN_OMP_PRAGMA(parallel for reduction(+ : useful))
+    for (int64_t i = 0; i < static_cast<int64_t>(length(set1)); ++i)
+        useful += bandCells(options, length(set1[i]), length(set2[i]));
+    res.useful = useful;
+    res.computed = computedCells(options, execPolicy, set1, set2, res.useful);
+    return res;
+}
+
+#endif  // CELL_ACCOUNTING_HPP_
@@ -0,0 +1,330 @@
+// ==========================================================================
+//                 SeqAn - The Library for Sequence Analysis
+// ==========================================================================
+// Copyright (c) 2006-2018, Knut Reinert, FU Berlin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Knut Reinert or the FU Berlin nor the names of
+//       its contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Rene Rahn <rene.rahn@fu-berlin.de>
+// ==========================================================================
+
+#ifndef COMPACT_ALIGNMENT_HPP_
+#define COMPACT_ALIGNMENT_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <seqan/basic.h>
+#include <seqan/align.h>
+
+#include "output_writer.hpp"
+
+using namespace seqan;
+
+// ============================================================================
+// Tags, Classes, Enums
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Class CompactAlignment
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class CompactAlignment
+ * @headerfile compact_alignment.hpp
+ * @brief Pairwise alignment stored as run-length encoded CIGAR and the aligned source ranges.
+ *
+ * The operations are encoded as in BAM, <tt>length << 4 | op</tt> with <tt>op</tt> indexing <tt>"MIDNSHP=X"</tt>.
+ * The horizontal sequence is the query and the vertical sequence the reference: a gap in the query is a deletion
+ * (<tt>D</tt>), a gap in the reference an insertion (<tt>I</tt>).
+ */
+struct CompactAlignment
+{
+    static constexpr uint32_t CIGAR_MATCH = 0;
+    static constexpr uint32_t CIGAR_INS = 1;
+    static constexpr uint32_t CIGAR_DEL = 2;
+    static constexpr uint32_t CIGAR_SOFT_CLIP = 4;
+
+    std::vector<uint32_t> cigar;
+    uint64_t beginH{0};
+    uint64_t endH{0};
+    uint64_t lengthH{0};
+    uint64_t beginV{0};
+    uint64_t endV{0};
+    uint64_t lengthV{0};
+    uint64_t matches{0};  // Aligned identical residues.
+    uint64_t edits{0};    // Mismatches and gap columns.
+    uint64_t columns{0};  // Alignment columns.
+};
+
+constexpr uint32_t CompactAlignment::CIGAR_MATCH;
+constexpr uint32_t CompactAlignment::CIGAR_INS;
+constexpr uint32_t CompactAlignment::CIGAR_DEL;
+constexpr uint32_t CompactAlignment::CIGAR_SOFT_CLIP;
+
+// ============================================================================
+// Functions
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Function appendCigarOperation()
+// ----------------------------------------------------------------------------
+
+inline void
+appendCigarOperation(std::vector<uint32_t> & cigar, uint32_t const op, uint32_t const count = 1)
+{
+    if (!cigar.empty() && (cigar.back() & 0xF) == op)
+        cigar.back() += count << 4;
+    else
+        cigar.push_back(count << 4 | op);
+}
+
+// ----------------------------------------------------------------------------
+// Function compactAlignment()
+// ----------------------------------------------------------------------------
+
+/*!
+ * @fn compactAlignment
+ * @headerfile compact_alignment.hpp
+ * @brief Converts the two rows of a computed alignment into a @link CompactAlignment @endlink.
+ *
+ * @signature void compactAlignment(alignment, gapsH, gapsV);
+ *
+ * Walks the clipped alignment columns once. The previous contents of <tt>alignment</tt> are replaced, the capacity
+ * of its CIGAR is reused.
+ */
+template <typename TGapsH, typename TGapsV>
+inline void
+compactAlignment(CompactAlignment & alignment, TGapsH const & gapsH, TGapsV const & gapsV)
+{
+    alignment.cigar.clear();
+    alignment.beginH = beginPosition(gapsH);
+    alignment.endH = endPosition(gapsH);
+    alignment.lengthH = length(source(gapsH));
+    alignment.beginV = beginPosition(gapsV);
+    alignment.endV = endPosition(gapsV);
+    alignment.lengthV = length(source(gapsV));
+    alignment.matches = 0;
+    alignment.edits = 0;
+    alignment.columns = 0;
+
+    auto const & seqH = source(gapsH);
+    auto const & seqV = source(gapsV);
+    uint64_t posH = alignment.beginH;
+    uint64_t posV = alignment.beginV;
+
+    auto itH = begin(gapsH, Standard());
+    auto itV = begin(gapsV, Standard());
+    auto itEndH = end(gapsH, Standard());
+    auto itEndV = end(gapsV, Standard());
+    // A row that ends earlier is treated as gapped.
+    for (; itH != itEndH || itV != itEndV;)
+    {
+        bool const gapH = (itH == itEndH) || isGap(itH);
+        bool const gapV = (itV == itEndV) || isGap(itV);
+        if (!gapH && !gapV)
+        {
+            appendCigarOperation(alignment.cigar, CompactAlignment::CIGAR_MATCH);
+            if (seqH[posH] == seqV[posV])
+                ++alignment.matches;
+            else
+                ++alignment.edits;
+            ++posH;
+            ++posV;
+            ++alignment.columns;
+        }
+        else if (gapH && !gapV)
+        {
+            appendCigarOperation(alignment.cigar, CompactAlignment::CIGAR_DEL);
+            ++posV;
+            ++alignment.edits;
+            ++alignment.columns;
+        }
+        else if (!gapH && gapV)
+        {
+            appendCigarOperation(alignment.cigar, CompactAlignment::CIGAR_INS);
+            ++posH;
+            ++alignment.edits;
+            ++alignment.columns;
+        }
+
+        if (itH != itEndH)
+            ++itH;
+        if (itV != itEndV)
+            ++itV;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Function appendCigar()
+// ----------------------------------------------------------------------------
+
+// Appends the CIGAR string, with the unaligned ends of the query as soft clips if softClip is set, or "*".
+inline void
+appendCigar(std::string & buffer, CompactAlignment const & alignment, bool const softClip = false)
+{
+    static char const operations[] = "MIDNSHP=X";
+    char number[24];
+
+    auto appendOperation = [&] (uint64_t const count, uint32_t const op)
+    {
+        buffer.append(number, formatInteger(number, count));
+        buffer += operations[op];
+    };
+
+    if (alignment.cigar.empty())
+    {
+        buffer += '*';
+        return;
+    }
+
+    if (softClip && alignment.beginH > 0)
+        appendOperation(alignment.beginH, CompactAlignment::CIGAR_SOFT_CLIP);
+    for (uint32_t const op : alignment.cigar)
+        appendOperation(op >> 4, op & 0xF);
+    if (softClip && alignment.endH < alignment.lengthH)
+        appendOperation(alignment.lengthH - alignment.endH, CompactAlignment::CIGAR_SOFT_CLIP);
+}
+
+// ----------------------------------------------------------------------------
+// Function appendCigarRecord()
+// ----------------------------------------------------------------------------
+
+// <id> <score> <query begin> <query end> <reference begin> <reference end> <CIGAR>, tab separated.
+template <typename TScore>
+inline void
+appendCigarRecord(std::string & buffer, uint64_t const id, CompactAlignment const & alignment, TScore const score)
+{
+    char number[24];
+    auto appendField = [&] (auto const value)
+    {
+        buffer.append(number, formatInteger(number, value));
+        buffer += '\t';
+    };
+
+    appendField(id);
+    appendField(score);
+    appendField(alignment.beginH);
+    appendField(alignment.endH);
+    appendField(alignment.beginV);
+    appendField(alignment.endV);
+    appendCigar(buffer, alignment);
+    buffer += '\n';
+}
+
+// ----------------------------------------------------------------------------
+// Function appendSamReference()
+// ----------------------------------------------------------------------------
+
+// Appends the @SQ header line of the reference of an alignment, named by the alignment number. Empty references
+// are left out, since SAM requires a positive length. Their alignments are written as unmapped.
+inline void
+appendSamReference(std::string & buffer, uint64_t const id, CompactAlignment const & alignment)
+{
+    if (alignment.lengthV == 0)
+        return;
+
+    char number[24];
+    buffer += "@SQ\tSN:";
+    buffer.append(number, formatInteger(number, id));
+    buffer += "\tLN:";
+    buffer.append(number, formatInteger(number, alignment.lengthV));
+    buffer += '\n';
+}
+
+// ----------------------------------------------------------------------------
+// Function appendSamRecord()
+// ----------------------------------------------------------------------------
+
+// Query and reference are named by the alignment number, the sequences and qualities are omitted. The references
+// are declared by appendSamReference().
+template <typename TScore>
+inline void
+appendSamRecord(std::string & buffer, uint64_t const id, CompactAlignment const & alignment, TScore const score)
+{
+    char number[24];
+    auto appendNumber = [&] (auto const value)
+    {
+        buffer.append(number, formatInteger(number, value));
+    };
+
+    bool const mapped = !alignment.cigar.empty() && alignment.lengthV != 0;
+    appendNumber(id);                                   // QNAME
+    buffer += (mapped) ? "\t0\t" : "\t4\t";             // FLAG
+    if (mapped)
+        appendNumber(id);                               // RNAME
+    else
+        buffer += '*';
+    buffer += '\t';
+    appendNumber((mapped) ? alignment.beginV + 1 : 0);  // POS
+    buffer += "\t255\t";                                // MAPQ
+    appendCigar(buffer, alignment, true);               // CIGAR
+    buffer += "\t*\t0\t0\t*\t*\tAS:i:";                 // RNEXT PNEXT TLEN SEQ QUAL
+    appendNumber(score);
+    buffer += "\tNM:i:";
+    appendNumber(alignment.edits);
+    buffer += '\n';
+}
+
+// ----------------------------------------------------------------------------
+// Function appendPafRecord()
+// ----------------------------------------------------------------------------
+
+template <typename TScore>
+inline void
+appendPafRecord(std::string & buffer, uint64_t const id, CompactAlignment const & alignment, TScore const score)
+{
+    char number[24];
+    auto appendField = [&] (auto const value)
+    {
+        buffer.append(number, formatInteger(number, value));
+        buffer += '\t';
+    };
+
+    appendField(id);
+    appendField(alignment.lengthH);
+    appendField(alignment.beginH);
+    appendField(alignment.endH);
+    buffer += "+\t";
+    appendField(id);
+    appendField(alignment.lengthV);
+    appendField(alignment.beginV);
+    appendField(alignment.endV);
+    appendField(alignment.matches);
+    appendField(alignment.columns);
+    buffer += "255\tAS:i:";
+    buffer.append(number, formatInteger(number, score));
+    buffer += "\tNM:i:";
+    buffer.append(number, formatInteger(number, alignment.edits));
+    buffer += "\tcg:Z:";
+    appendCigar(buffer, alignment);
+    buffer += '\n';
+}
+
+#endif  // COMPACT_ALIGNMENT_HPP_
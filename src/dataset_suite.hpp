@@ -0,0 +1,291 @@
+// ==========================================================================
+//                 SeqAn - The Library for Sequence Analysis
+// ==========================================================================
+// Copyright (c) 2006-2018, Knut Reinert, FU Berlin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Knut Reinert or the FU Berlin nor the names of
+//       its contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Rene Rahn <rene.rahn@fu-berlin.de>
+// ==========================================================================
+
+#ifndef DATASET_SUITE_HPP_
+#define DATASET_SUITE_HPP_
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "align_bench_options.hpp"
+
+// ============================================================================
+// Tags, Classes, Enums
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Class BenchmarkDataset
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class BenchmarkDataset
+ * @headerfile dataset_suite.hpp
+ * @brief Pinned simulation parameters of a data set of the benchmark suite.
+ *
+ * The data sets are built once by <tt>align_bench_datasets</tt> and cached as binary sequence databases, which the
+ * benchmarks refer to by name. Every parameter, including the seed, is fixed, so the same suite version yields the
+ * same sequences on every machine. Changing a data set, the simulation or the database format requires a new
+ * <tt>DATASET_SUITE_VERSION</tt>, which invalidates all caches.
+ */
+struct BenchmarkDataset
+{
+    std::string             name;
+    std::string             description;
+    ScoreAlphabet           alpha;
+    AlignmentMode           mode;
+    unsigned                numSequences;
+    DistributionFunction    distFunction;
+    unsigned                minSize;
+    unsigned                maxSize;
+    double                  mean;
+    double                  sd;
+    double                  identity;       // Negative for independent sets.
+    unsigned                families;       // Both sets are mutated family members if not 0.
+    unsigned                genomeLength;   // The reads are sampled from a simulated genome if not 0.
+    uint32_t                seed;
+};
+
+// Version of the suite, part of the cached file names.
+constexpr unsigned DATASET_SUITE_VERSION = 3;
+
+// ============================================================================
+// Functions
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Function benchmarkDatasets()
+// ----------------------------------------------------------------------------
+
+inline std::vector<BenchmarkDataset> const &
+benchmarkDatasets()
+{
+    static std::vector<BenchmarkDataset> const suite
+    {
+        {"illumina-100k", "100k short-read pairs of 100-151 bp at 95% identity",
+         ScoreAlphabet::DNA, AlignmentMode::PAIR, 100000,
+         DistributionFunction::NORMAL_DISTRIBUTION, 100, 151, 150, 1, 0.95, 0, 0, 101},
+        {"hifi-10k", "10k HiFi read pairs of 5-35 kbp at 99% identity",
+         ScoreAlphabet::DNA, AlignmentMode::PAIR, 10000,
+         DistributionFunction::LOGNORMAL_DISTRIBUTION, 5000, 35000, 15000, 4000, 0.99, 0, 0, 102},
+        {"ont-1k", "1k nanopore read pairs of 0.2-200 kbp at 90% identity",
+         ScoreAlphabet::DNA, AlignmentMode::PAIR, 1000,
+         DistributionFunction::LOGNORMAL_DISTRIBUTION, 200, 200000, 12000, 12000, 0.90, 0, 0, 103},
+        {"protein-search-1k", "1k protein queries against 1k proteins of 50 families at 50% identity",
+         ScoreAlphabet::AMINOACID, AlignmentMode::SEARCH, 1000,
+         DistributionFunction::GAMMA_DISTRIBUTION, 20, 35000, 360, 300, 0.50, 50, 0, 104},
+        {"olc-500", "500 reads of 1-4 kbp sampled at 20x coverage from a 50 kbp genome at 99% identity",
+         ScoreAlphabet::DNA, AlignmentMode::OLC, 500,
+         DistributionFunction::NORMAL_DISTRIBUTION, 1000, 4000, 2000, 500, 0.99, 0, 50000, 105},
+        {"mixed-10k", "10k pairs of 0.1-50 kbp with Pareto distributed lengths at 90% identity",
+         ScoreAlphabet::DNA, AlignmentMode::PAIR, 10000,
+         DistributionFunction::PARETO_DISTRIBUTION, 100, 50000, 2000, -1, 0.90, 0, 0, 106}
+    };
+    return suite;
+}
+
+// ----------------------------------------------------------------------------
+// Function findBenchmarkDataset()
+// ----------------------------------------------------------------------------
+
+// Returns the data set of the given name or nullptr if the suite has none.
+inline BenchmarkDataset const *
+findBenchmarkDataset(std::string const & name)
+{
+    for (auto const & dataset : benchmarkDatasets())
+        if (dataset.name == name)
+            return &dataset;
+    return nullptr;
+}
+
+// ----------------------------------------------------------------------------
+// Function datasetNames()
+// ----------------------------------------------------------------------------
+
+// The names of all data sets separated by blanks, e.g. as valid values of an option.
+inline std::string
+datasetNames()
+{
+    std::string names;
+    for (auto const & dataset : benchmarkDatasets())
+        names += (names.empty() ? "" : " ") + dataset.name;
+    return names;
+}
+
+// ----------------------------------------------------------------------------
+// Function defaultDatasetDir()
+// ----------------------------------------------------------------------------
+
+// The cache directory given by ALIGN_BENCH_DATASETS, otherwise "datasets" in the working directory.
+inline std::string
+defaultDatasetDir()
+{
+    char const * dir = std::getenv("ALIGN_BENCH_DATASETS");
+    return (dir != nullptr && *dir != '\0') ? dir : "datasets";
+}
+
+// ----------------------------------------------------------------------------
+// Function datasetFile()
+// ----------------------------------------------------------------------------
+
+// Path of a cached file of the data set, e.g. <dir>/hifi-10k.v3.query.abdb.
+inline std::string
+datasetFile(std::string const & dir, BenchmarkDataset const & dataset, std::string const & part)
+{
+    std::ostringstream path;
+    path << dir << "/" << dataset.name << ".v" << DATASET_SUITE_VERSION << "." << part;
+    return path.str();
+}
+
+inline std::string
+datasetQueryFile(std::string const & dir, BenchmarkDataset const & dataset)
+{
+    return datasetFile(dir, dataset, "query.abdb");
+}
+
+// The OLC data sets consist of the reads only, which are aligned with each other.
+inline std::string
+datasetDatabaseFile(std::string const & dir, BenchmarkDataset const & dataset)
+{
+    return (dataset.mode == AlignmentMode::OLC) ? datasetQueryFile(dir, dataset)
+                                                : datasetFile(dir, dataset, "db.abdb");
+}
+
+inline std::string
+datasetChecksumFile(std::string const & dir, BenchmarkDataset const & dataset)
+{
+    return datasetFile(dir, dataset, "checksums");
+}
+
+// ----------------------------------------------------------------------------
+// Function fileChecksum()
+// ----------------------------------------------------------------------------
+
+// 64 bit FNV-1a hash of the file content. Returns false if the file cannot be read.
+inline bool
+fileChecksum(uint64_t & checksum, std::string const & fileName)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file)
+        return false;
+
+    checksum = 0xcbf29ce484222325ull;
+    std::vector<char> buffer(1 << 20);
+    while (file.read(buffer.data(), buffer.size()) || file.gcount() > 0)
+    {
+        for (std::streamsize i = 0; i < file.gcount(); ++i)
+            checksum = (checksum ^ static_cast<unsigned char>(buffer[i])) * 0x100000001b3ull;
+    }
+    return file.eof();
+}
+
+// ----------------------------------------------------------------------------
+// Function writeDatasetChecksums()
+// ----------------------------------------------------------------------------
+
+// Writes the checksums of the cached files of the data set, one "<checksum>  <file>" line per file.
+inline bool
+writeDatasetChecksums(std::string const & dir, BenchmarkDataset const & dataset)
+{
+    std::vector<std::string> files{datasetQueryFile(dir, dataset)};
+    if (datasetDatabaseFile(dir, dataset) != files.front())
+        files.push_back(datasetDatabaseFile(dir, dataset));
+
+    std::ofstream out(datasetChecksumFile(dir, dataset));
+    for (auto const & file : files)
+    {
+        uint64_t checksum = 0;
+        if (!fileChecksum(checksum, file))
+            return false;
+
+        char hex[17];
+        std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(checksum));
+        out << hex << "  " << file.substr(file.find_last_of('/') + 1) << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+// ----------------------------------------------------------------------------
+// Function verifyDataset()
+// ----------------------------------------------------------------------------
+
+// Checks that the cached files of the data set exist and match their checksums. Otherwise returns false and
+// describes the first failure in error.
+inline bool
+verifyDataset(std::string & error, std::string const & dir, BenchmarkDataset const & dataset)
+{
+    std::ifstream in(datasetChecksumFile(dir, dataset));
+    if (!in)
+    {
+        error = "Data set " + dataset.name + " is not cached in " + dir + ".";
+        return false;
+    }
+
+    std::vector<std::string> const files{datasetQueryFile(dir, dataset), datasetDatabaseFile(dir, dataset)};
+    std::vector<bool> verified(files.size(), false);
+    std::string expected;
+    std::string fileName;
+    while (in >> expected >> fileName)
+    {
+        uint64_t checksum = 0;
+        if (!fileChecksum(checksum, dir + "/" + fileName))
+        {
+            error = "Could not read " + dir + "/" + fileName + ".";
+            return false;
+        }
+        if (std::strtoull(expected.c_str(), nullptr, 16) != checksum)
+        {
+            error = dir + "/" + fileName + " does not match its checksum.";
+            return false;
+        }
+        for (size_t i = 0; i < files.size(); ++i)
+            verified[i] = verified[i] || files[i] == dir + "/" + fileName;
+    }
+
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        if (!verified[i])
+        {
+            error = "No checksum of " + files[i] + ".";
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif  // DATASET_SUITE_HPP_
@@ -2,11 +2,13 @@
 //#define SEQAN_ENABLE_TESTING 0
 //#define SEQAN_ENABLE_DEBUG 0
 
-#define DP_ALIGN_STATS
+//#define DP_ALIGN_STATS
 
 #include <cxxabi.h>
 #include <array>
 #include <future>
+#include <memory>
+#include <thread>
 
 #ifdef DP_ALIGN_STATS
 std::atomic<uint32_t> simdCounter;
@@ -18,7 +20,7 @@ std::atomic<uint32_t> serialCounter;
 
 #include <seqan/basic.h>
 #include <seqan/align.h>
-#include <seqan/align_parallel_2.h>
+#include <seqan/align_parallel.h>
 
 #include <seqan/arg_parse.h>
 #include <seqan/stream.h>
@@ -27,7 +29,10 @@ std::atomic<uint32_t> serialCounter;
 
 #include "align_bench_options.hpp"
 #include "sequence_generator.hpp"
-#include "benchmark_executor.hpp"
+#include "align_bench_seqan.hpp"
+#include "parallel_reader.hpp"
+#include "bounded_queue.hpp"
+#include "output_writer.hpp"
 
 using namespace seqan;
 
@@ -64,15 +69,37 @@ parseCommandLine(AlignBenchOptions & options, int const argc, char* argv[])
     addOption(parser, seqan::ArgParseOption("o", "output", "Output file to write the alignment to.", seqan::ArgParseArgument::OUTPUT_FILE, "OUT"));
     setDefaultValue(parser, "o", "align_bench_res.csv");
 
+    addOption(parser, seqan::ArgParseOption("", "score-format", "Format of the written scores. binary writes a header followed by the raw 32 bit scores.", seqan::ArgParseArgument::STRING, "STR"));
+    setValidValues(parser, "score-format", "text binary");
+    setDefaultValue(parser, "score-format", "text");
+
+    addOption(parser, seqan::ArgParseOption("", "direct-io", "Writes the output file with O_DIRECT, bypassing the page cache, if the file system supports it."));
+
+    addOption(parser, seqan::ArgParseOption("r", "repetition", "Number of repeated runs.", seqan::ArgParseArgument::INTEGER, "INT"));
+    setMinValue(parser, "r", "1");
+    setDefaultValue(parser, "r", "1");
+
+    addOption(parser, seqan::ArgParseOption("w", "warmup", "Number of untimed warm-up runs executed before the timed runs.", seqan::ArgParseArgument::INTEGER, "INT"));
+    setMinValue(parser, "w", "0");
+    setDefaultValue(parser, "w", "0");
+
     addOption(parser, seqan::ArgParseOption("e", "execution-mode", "Parallelization strategy. If not set, execution is forced to serial mode", seqan::ArgParseArgument::STRING, "STR"));
     setValidValues(parser, "e", "seq par par_vec wave wave_vec");
 
     addOption(parser, seqan::ArgParseOption("t", "threads", "Number of threads", seqan::ArgParseArgument::INTEGER, "INT"));
-    setDefaultValue(parser, "t", toString(std::thread::hardware_concurrency()));
+    setDefaultValue(parser, "t", toString(defaultThreadCount()));
+
+    addOption(parser, seqan::ArgParseOption("", "reader-threads", "Number of threads parsing the FASTA/FASTQ inputs.", seqan::ArgParseArgument::INTEGER, "INT"));
+    setMinValue(parser, "reader-threads", "1");
+    setDefaultValue(parser, "reader-threads", toString(defaultThreadCount()));
+
+    addOption(parser, seqan::ArgParseOption("", "stream-batch", "Streams the queries in batches of the given number of records, such that reading, aligning and writing overlap. The streamed queries are parsed by a single thread. 0 reads the query file at once.", seqan::ArgParseArgument::INT64, "INT"));
+    setMinValue(parser, "stream-batch", "0");
+    setDefaultValue(parser, "stream-batch", "0");
 
     addOption(parser, seqan::ArgParseOption("p", "parallel-instances", "Number of parallel alignment instances", seqan::ArgParseArgument::INTEGER, "INT"));
     setMinValue(parser, "p", "1");
-    setDefaultValue(parser, "p", toString(std::thread::hardware_concurrency() << 1));
+    setDefaultValue(parser, "p", toString(defaultThreadCount() << 1));
 
     addOption(parser, seqan::ArgParseOption("s", "score-width", "Width of integers in bits used for score", seqan::ArgParseArgument::STRING, "STR"));
     setValidValues(parser, "s", "16 32 64");
@@ -98,6 +125,13 @@ parseCommandLine(AlignBenchOptions & options, int const argc, char* argv[])
 
     getOptionValue(options.alignOut, parser, "o");
 
+    std::string scoreFormat;
+    getOptionValue(scoreFormat, parser, "score-format");
+    options.scoreFormat = (scoreFormat == "binary") ? ScoreFormat::BINARY : ScoreFormat::TEXT;
+    options.directIo = isSet(parser, "direct-io");
+    getOptionValue(options.rep, parser, "r");
+    getOptionValue(options.warmup, parser, "w");
+
     std::string tmp;
     if (getOptionValue(tmp, parser, "e"))
     {
@@ -133,7 +167,7 @@ parseCommandLine(AlignBenchOptions & options, int const argc, char* argv[])
     {
         if (options.stats.method == "global")
             options.method = AlignMethod::GLOBAL;
-        else if (options.stats.method == "semiglobal")
+        else if (options.stats.method == "semi")
             options.method = AlignMethod::SEMIGLOBAL;
         else if (options.stats.method == "local")
             options.method = AlignMethod::LOCAL;
@@ -141,6 +175,11 @@ parseCommandLine(AlignBenchOptions & options, int const argc, char* argv[])
 
     getOptionValue(options.threadCount, parser, "t");
     getOptionValue(options.parallelInstances, parser, "p");
+    getOptionValue(options.readerThreads, parser, "reader-threads");
+
+    int64_t streamBatch = 0;
+    getOptionValue(streamBatch, parser, "stream-batch");
+    options.streamBatch = static_cast<size_t>(streamBatch);
 
     // Read block size.
     getOptionValue(options.blockSize, parser, "b");
@@ -148,16 +187,205 @@ parseCommandLine(AlignBenchOptions & options, int const argc, char* argv[])
     return ArgumentParser::PARSE_OK;
 }
 
-template <typename... TArgs>
+template <typename TSetH, typename TSetV, typename TScore, typename TExecPolicy>
 inline void invoke(AlignBenchOptions & options,
-                   TArgs &&... args)
+                   TSetH & setH,
+                   TSetV & setV,
+                   TScore const & score,
+                   TExecPolicy const & exec)
 {
     std::cout << "Invoke Alignment...\t" << std::flush;
     BenchmarkExecutor device;
-    device.runGlobalAlignment(options, std::forward<TArgs>(args)...);
+    device.runAlignment(options, exec, setH, setV, score);
     std::cout << "\t\t\tdone." << std::endl;
     device.printProfile(std::cout);
     options.stats.time = device.getTime();
+    options.stats.runTimes = device.getRunTimes();
+    options.stats.warmupRuns = options.warmup;
+    options.stats.memory = device.getMemoryStats();
+    options.stats.energy = device.getEnergyStats();
+    options.stats.totalCells = device.getCellCounts().useful;
+    options.stats.computedCells = device.getCellCounts().computed;
+    options.stats.phases += device.getPhases();
+}
+
+// ----------------------------------------------------------------------------
+// Class QueryStream
+// ----------------------------------------------------------------------------
+
+// The database held in memory and the query file, which is read in batches of batchSize records.
+template <typename TAlphabet>
+struct QueryStream
+{
+    StringSet<String<TAlphabet>> & database;
+    std::string                    queryFile;
+    size_t                         batchSize;
+};
+
+// ----------------------------------------------------------------------------
+// Function accumulateBatch()
+// ----------------------------------------------------------------------------
+
+// Adds the measurements of one streamed batch to the totals of the stream. The timed runs of all batches are summed
+// run by run, the memory peaks are the maxima over the batches.
+inline void
+accumulateBatch(AlignBenchOptions & options, BenchmarkExecutor & device)
+{
+    options.stats.time += device.getTime();
+
+    auto const & runTimes = device.getRunTimes();
+    options.stats.runTimes.resize(std::max(options.stats.runTimes.size(), runTimes.size()), 0.0);
+    for (size_t i = 0; i < runTimes.size(); ++i)
+        options.stats.runTimes[i] += runTimes[i];
+
+    MemoryStats const memory = device.getMemoryStats();
+    options.stats.memory.heapTracked = memory.heapTracked;
+    options.stats.memory.peakRss = std::max(options.stats.memory.peakRss, memory.peakRss);
+    options.stats.memory.rssGrowth = std::max(options.stats.memory.rssGrowth, memory.rssGrowth);
+    options.stats.memory.allocs += memory.allocs;
+    options.stats.memory.peakHeap = std::max(options.stats.memory.peakHeap, memory.peakHeap);
+
+    EnergyStats const energy = device.getEnergyStats();
+    if (energy.packageJoules >= 0.0)
+        options.stats.energy.packageJoules = std::max(options.stats.energy.packageJoules, 0.0) + energy.packageJoules;
+    if (energy.dramJoules >= 0.0)
+        options.stats.energy.dramJoules = std::max(options.stats.energy.dramJoules, 0.0) + energy.dramJoules;
+
+    options.stats.totalCells += device.getCellCounts().useful;
+    options.stats.computedCells += device.getCellCounts().computed;
+}
+
+// ----------------------------------------------------------------------------
+// Function invoke()                                             [QueryStream]
+// ----------------------------------------------------------------------------
+
+// Three stage pipeline: a reader thread parses the next query batches, the calling thread aligns batch k
+// against the database with the configured policy and a writer thread writes the scores of batch k-1.
+// At most two query batches and one score batch are buffered, such that the memory stays bounded by the
+// database and a few batches independent of the size of the query file. Binary scores are an exception, since
+// their header holds the number of scores: they are collected and written when the stream ends.
+// Every batch is measured by the BenchmarkExecutor with the warm-up and timed runs of the options, and the reported
+// time is the sum of the kernel times of the batches. The wall time of the whole pipeline is printed separately.
+template <typename TAlphabet, typename TScore, typename TExecPolicy>
+inline void
+invoke(AlignBenchOptions & options,
+       QueryStream<TAlphabet> & stream,
+       TScore const & score,
+       TExecPolicy const & exec)
+{
+    using TQueries = StringSet<String<TAlphabet>>;
+    using TScores = std::vector<int32_t>;
+
+    BoundedQueue<std::unique_ptr<TQueries>> queryQueue(2);
+    BoundedQueue<std::unique_ptr<TScores>> scoreQueue(1);
+
+    // The executor writes the scores of a batch unless the output file is empty, the writer thread does it instead.
+    std::string alignOut;
+    std::swap(alignOut, options.alignOut);
+
+    std::cout << "Stream Alignments...\t" << std::flush;
+    Timer<double> timer;
+    start(timer);
+
+    std::thread reader([&] ()
+    {
+        try
+        {
+            SeqFileIn queryFile(stream.queryFile.c_str());
+            while (!atEnd(queryFile))
+            {
+                StringSet<CharString> ids;
+                std::unique_ptr<TQueries> queries(new TQueries);
+                readRecords(ids, *queries, queryFile, stream.batchSize);
+                if (!queryQueue.push(std::move(queries)))
+                    break;
+            }
+        }
+        catch (Exception const & e)
+        {
+            std::cerr << "\nCould not read query file: " << e.what() << std::endl;
+        }
+        queryQueue.close();
+    });
+
+    std::thread writer([&] ()
+    {
+        OutputFile out;
+        if (!alignOut.empty() && !out.open(alignOut, options.directIo))
+            std::cerr << "Could not open file << " << alignOut.c_str() << ">>!" << std::endl;
+
+        // Keep draining the queue if there is nothing to write, otherwise the aligning thread blocks.
+        bool const binary = (options.scoreFormat == ScoreFormat::BINARY);
+        std::string buffer;
+        TScores binaryScores;
+        std::unique_ptr<TScores> scores;
+        while (scoreQueue.pop(scores))
+        {
+            if (!out.good())
+                continue;
+            if (binary)
+            {
+                binaryScores.insert(binaryScores.end(), scores->begin(), scores->end());
+                continue;
+            }
+            buffer.clear();
+            appendScoresText(buffer, *scores, 0, scores->size());
+            out.write(buffer);
+        }
+
+        if (out.good())
+        {
+            if (binary)
+                writeScoresBinary(out, binaryScores);
+            else  // The final empty line of writeScoresText().
+                out.write("\n", 1);
+        }
+        if (out.isOpen() && !out.close())
+            std::cerr << "Could not write file << " << alignOut.c_str() << ">>!" << std::endl;
+    });
+
+    options.stats.time = 0.0;
+    options.stats.runTimes.clear();
+    options.stats.totalCells = 0;
+    options.stats.computedCells = 0;
+    options.stats.memory = MemoryStats{};
+    options.stats.energy = EnergyStats{};
+
+    BenchmarkExecutor device;
+    size_t numBatches = 0;
+    std::unique_ptr<TQueries> queries;
+    while (queryQueue.pop(queries))
+    {
+        // The pairs are ordered query-major, as in the search without streaming.
+        StringSet<String<TAlphabet>, Dependent<Tight>> setH;
+        StringSet<String<TAlphabet>, Dependent<Tight>> setV;
+        for (auto & query : *queries)
+        {
+            options.stats.seqMinLength = std::min<size_t>(options.stats.seqMinLength, length(query));
+            options.stats.seqMaxLength = std::max<size_t>(options.stats.seqMaxLength, length(query));
+            for (auto & subject : stream.database)
+            {
+                appendValue(setH, subject);
+                appendValue(setV, query);
+            }
+        }
+        options.stats.numAlignments += length(setH);
+
+        device.runAlignment(options, exec, setH, setV, score);
+        accumulateBatch(options, device);
+        scoreQueue.push(std::unique_ptr<TScores>(new TScores(std::move(options.stats.scores))));
+        options.stats.scores.clear();
+        ++numBatches;
+    }
+    scoreQueue.close();
+    writer.join();
+    reader.join();
+
+    stop(timer);
+    std::swap(alignOut, options.alignOut);
+    std::cout << "\t\t\tdone (" << numBatches << " batches, " << getValue(timer) << " s wall time)." << std::endl;
+    options.stats.warmupRuns = options.warmup;
+    options.stats.phases += device.getPhases();
 }
 
 template <typename... TArgs>
@@ -250,6 +478,29 @@ configureScore(AminoAcid const & /*tag*/,
                   ScoreMatrix<AminoAcid, ScoreSpecBlosum62> >(-1 , -11));
 }
 
+template <typename TAlphabet, typename... TArgs>
+inline void
+configureScoreValue(TAlphabet const & /*tag*/,
+                    AlignBenchOptions & options,
+                    TArgs &&... args)
+{
+    switch(options.simdWidth)
+    {
+        case SimdIntegerWidth::BIT_16:
+            options.stats.scoreValue = "int16_t";
+            configureScore<int16_t>(TAlphabet(), options, std::forward<TArgs>(args)...);
+            break;
+        case SimdIntegerWidth::BIT_32:
+            options.stats.scoreValue = "int32_t";
+            configureScore<int32_t>(TAlphabet(), options, std::forward<TArgs>(args)...);
+            break;
+        case SimdIntegerWidth::BIT_64:
+            options.stats.scoreValue = "int64_t";
+            configureScore<int64_t>(TAlphabet(), options, std::forward<TArgs>(args)...);
+            break;
+    }
+}
+
 template <typename TAlphabet>
 inline void
 configureAlpha(AlignBenchOptions & options)
@@ -263,27 +514,20 @@ configureAlpha(AlignBenchOptions & options)
     StringSet<CharString> meta1;
     StringSet<CharString> meta2;
 
-    // read query.
-    try {
-        std::cout << "Reading query";
-        SeqFileIn queryFile{options.queryFile.c_str()};
-        readRecords(meta1, seqSet2, queryFile);
-    } catch(...)
+    // read query, unless it is streamed in batches after the database has been read.
+    if (options.streamBatch == 0)
     {
-        std::cerr << "\nCould not open or read  query file" << std::endl;
-        return;
+        std::cout << "Reading query";
+        if (!readSequences(meta1, seqSet2, options.queryFile, options.readerThreads, &options.stats.decompression))
+        {
+            std::cerr << "\nCould not open or read  query file" << std::endl;
+            return;
+        }
+        std::cout << " ... done\n";
     }
-    std::cout << " ... done\n";
     // read database.
-    try {
-        std::cout << "Reading database";
-        SeqFileIn dbFile{options.databaseFile.c_str()};
-        readRecords(meta2, seqSet1, dbFile);
-    } catch(ParseError & e)
-    {
-        std::cerr << e.what() << std::endl;
-        return;
-    } catch(...)
+    std::cout << "Reading database";
+    if (!readSequences(meta2, seqSet1, options.databaseFile, options.readerThreads, &options.stats.decompression))
     {
         std::cerr << "\nCould not open or read database file" << std::endl;
         return;
@@ -323,15 +567,23 @@ configureAlpha(AlignBenchOptions & options)
         return m;
     }(seqSet1, seqSet2);
 
+    options.stats.numSequences = length(seqSet1);
     options.stats.numAlignments = length(seqSet1) * length(seqSet2);
 
+    if (options.streamBatch > 0)
+    {
+        QueryStream<TAlphabet> stream{seqSet1, options.queryFile, options.streamBatch};
+        configureScoreValue(TAlphabet(), options, stream);
+        return;
+    }
+
     StringSet<String<TAlphabet>, Dependent<Tight>> setH;
     StringSet<String<TAlphabet>, Dependent<Tight>> setV;
 
     std::cout << "Calculating total size";
-    for (unsigned i = 0; i < length(seqSet1); ++i)
+    for (unsigned j = 0; j < length(seqSet2); ++j)
     {
-        for (unsigned j = 0; j < length(seqSet2); ++j)
+        for (unsigned i = 0; i < length(seqSet1); ++i)
         {
             options.stats.totalCells += (1+length(seqSet1[i]))*(1+length(seqSet2[j]));
             appendValue(setH, seqSet1[i]);
@@ -341,21 +593,7 @@ configureAlpha(AlignBenchOptions & options)
 
     std::cout << "\t ...done.\n";
 
-    switch(options.simdWidth)
-    {
-        case SimdIntegerWidth::BIT_16:
-            options.stats.scoreValue = "int16_t";
-            configureScore<int16_t>(TAlphabet(), options, setH, setV);
-            break;
-        case SimdIntegerWidth::BIT_32:
-            options.stats.scoreValue = "int32_t";
-            configureScore<int32_t>(TAlphabet(), options, setH, setV);
-            break;
-        case SimdIntegerWidth::BIT_64:
-            options.stats.scoreValue = "int64_t";
-            configureScore<int64_t>(TAlphabet(), options, setH, setV);
-            break;
-    }
+    configureScoreValue(TAlphabet(), options, setH, setV);
 }
 
 inline void
@@ -0,0 +1,287 @@
+// ==========================================================================
+//                 SeqAn - The Library for Sequence Analysis
+// ==========================================================================
+// Copyright (c) 2006-2018, Knut Reinert, FU Berlin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Knut Reinert or the FU Berlin nor the names of
+//       its contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Rene Rahn <rene.rahn@fu-berlin.de>
+// ==========================================================================
+
+#ifndef DECOMPRESSION_HPP_
+#define DECOMPRESSION_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <seqan/basic.h>
+#include <seqan/parallel.h>
+
+#if SEQAN_HAS_ZLIB
+#include <zlib.h>
+#endif  // SEQAN_HAS_ZLIB
+
+// ----------------------------------------------------------------------------
+// Class DecompressionStats
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class DecompressionStats
+ * @headerfile decompression.hpp
+ * @brief Volume and wall time of decompressing the inputs.
+ */
+struct DecompressionStats
+{
+    uint64_t    compressedBytes{0};
+    uint64_t    bytes{0};
+    double      seconds{0};
+
+    inline bool isAvailable() const
+    {
+        return compressedBytes > 0;
+    }
+
+    // Throughput in MB of decompressed data per second.
+    inline double mbPerSecond() const
+    {
+        return (seconds > 0) ? bytes / seconds / 1e6 : 0;
+    }
+};
+
+// ============================================================================
+// Functions
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Function isGzip()
+// ----------------------------------------------------------------------------
+
+inline bool isGzip(char const * begin, char const * end)
+{
+    return end - begin >= 18 && static_cast<uint8_t>(begin[0]) == 0x1f && static_cast<uint8_t>(begin[1]) == 0x8b;
+}
+
+namespace impl
+{
+namespace decompression
+{
+
+inline uint32_t readLittleEndian(char const * it, unsigned const bytes)
+{
+    uint32_t value = 0;
+    for (unsigned i = 0; i < bytes; ++i)
+        value |= static_cast<uint32_t>(static_cast<uint8_t>(it[i])) << (8 * i);
+    return value;
+}
+
+// Returns the size of the BGZF block starting at it, given by the BC subfield of its gzip header, or 0 if the
+// gzip member is no BGZF block.
+inline size_t bgzfBlockSize(char const * it, char const * end)
+{
+    if (!isGzip(it, end) || !(static_cast<uint8_t>(it[3]) & 0x04))  // FEXTRA
+        return 0;
+
+    char const * field = it + 12;
+    char const * fieldsEnd = field + readLittleEndian(it + 10, 2);
+    while (field + 4 <= fieldsEnd && fieldsEnd <= end)
+    {
+        unsigned const length = readLittleEndian(field + 2, 2);
+        if (field[0] == 'B' && field[1] == 'C' && length == 2)
+            return readLittleEndian(field + 4, 2) + 1;
+        field += 4 + length;
+    }
+    return 0;
+}
+
+#if SEQAN_HAS_ZLIB
+// Inflates the raw deflate stream of a single BGZF block into exactly size bytes at out.
+inline bool inflateBlock(char const * block, size_t const blockSize, char * out, size_t const size)
+{
+    size_t const headerSize = 12 + readLittleEndian(block + 10, 2);
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+        return false;
+
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(block + headerSize));
+    stream.avail_in = blockSize - headerSize - 8;
+    stream.next_out = reinterpret_cast<Bytef *>(out);
+    stream.avail_out = size;
+    int const status = inflate(&stream, Z_FINISH);
+    inflateEnd(&stream);
+
+    uint32_t const crc = crc32(crc32(0, Z_NULL, 0), reinterpret_cast<Bytef const *>(out), size);
+    return status == Z_STREAM_END && stream.total_out == size &&
+           crc == readLittleEndian(block + blockSize - 8, 4);
+}
+#endif  // SEQAN_HAS_ZLIB
+
+}  // namespace decompression
+}  // namespace impl
+
+// ----------------------------------------------------------------------------
+// Function inflateBgzf()
+// ----------------------------------------------------------------------------
+
+/*!
+ * @fn inflateBgzf
+ * @brief Decompresses BGZF data with multiple threads.
+ *
+ * @signature bool inflateBgzf(out, begin, end, threads)
+ *
+ * BGZF is a series of independent gzip members of at most 64 KiB, each storing its compressed size in the header
+ * and its uncompressed size (ISIZE) in the trailer. The block boundaries are found by following the headers and
+ * the prefix sums of ISIZE give the output position of every block, such that all blocks are inflated in parallel
+ * directly into <tt>out</tt>. Returns false if the data is no valid BGZF or zlib is not available.
+ */
+inline bool inflateBgzf(std::vector<char> & out, char const * begin, char const * end, unsigned const threads)
+{
+#if SEQAN_HAS_ZLIB
+    using namespace impl::decompression;
+
+    std::vector<size_t> blocks;
+    std::vector<size_t> offsets(1, 0);
+    for (char const * it = begin; it < end;)
+    {
+        size_t const blockSize = bgzfBlockSize(it, end);
+        if (blockSize < 26 || blockSize > static_cast<size_t>(end - it))
+            return false;
+        blocks.push_back(it - begin);
+        offsets.push_back(offsets.back() + readLittleEndian(it + blockSize - 4, 4));
+        it += blockSize;
+    }
+
+    out.resize(offsets.back());
+    bool valid = true;
+    SEQAN_OMP_PRAGMA(parallel for schedule(dynamic, 16) num_threads(std::max(threads, 1u)) reduction(&& : valid))
+    for (int64_t i = 0; i < static_cast<int64_t>(blocks.size()); ++i)
+    {
+        char const * block = begin + blocks[i];
+        size_t const size = offsets[i + 1] - offsets[i];
+        if (size > 0)
+            valid = inflateBlock(block, bgzfBlockSize(block, end), out.data() + offsets[i], size) && valid;
+    }
+    return valid;
+#else  // SEQAN_HAS_ZLIB
+    (void)out;
+    (void)begin;
+    (void)end;
+    (void)threads;
+    return false;
+#endif  // SEQAN_HAS_ZLIB
+}
+
+// ----------------------------------------------------------------------------
+// Function inflateGzip()
+// ----------------------------------------------------------------------------
+
+// Decompresses a gzip file consisting of one or more members in a single stream.
+inline bool inflateGzip(std::vector<char> & out, char const * begin, char const * end)
+{
+#if SEQAN_HAS_ZLIB
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+    if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK)
+        return false;
+
+    // The trailer of the last member holds its size modulo 2^32, which is a good first guess for the output.
+    size_t const hint = impl::decompression::readLittleEndian(end - 4, 4);
+    out.resize(std::max<size_t>(hint, 4 * (end - begin)));
+
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(begin));
+    stream.avail_in = end - begin;
+    size_t written = 0;
+    int status = Z_OK;
+    while (true)
+    {
+        if (written == out.size())
+            out.resize(2 * out.size());
+        stream.next_out = reinterpret_cast<Bytef *>(out.data() + written);
+        stream.avail_out = out.size() - written;
+        status = inflate(&stream, Z_NO_FLUSH);
+        written = out.size() - stream.avail_out;
+
+        if (status == Z_STREAM_END)
+        {
+            // Concatenated members are decompressed one after another.
+            if (stream.avail_in == 0)
+                break;
+            inflateReset(&stream);
+        }
+        else if (status != Z_OK && status != Z_BUF_ERROR)
+        {
+            break;
+        }
+        else if (status == Z_BUF_ERROR && stream.avail_in == 0)
+        {
+            break;  // Truncated input.
+        }
+    }
+    inflateEnd(&stream);
+    out.resize(written);
+    return status == Z_STREAM_END;
+#else  // SEQAN_HAS_ZLIB
+    (void)out;
+    (void)begin;
+    (void)end;
+    return false;
+#endif  // SEQAN_HAS_ZLIB
+}
+
+// ----------------------------------------------------------------------------
+// Function decompress()
+// ----------------------------------------------------------------------------
+
+/*!
+ * @fn decompress
+ * @brief Decompresses gzip data, using multiple threads for BGZF.
+ *
+ * @signature bool decompress(out, begin, end, threads[, stats])
+ *
+ * If <tt>stats</tt> is given, the compressed and decompressed volume and the wall time are added to it.
+ */
+inline bool decompress(std::vector<char> & out,
+                       char const * begin,
+                       char const * end,
+                       unsigned const threads,
+                       DecompressionStats * stats = nullptr)
+{
+    double const start = seqan::sysTime();
+    bool const res = (impl::decompression::bgzfBlockSize(begin, end) != 0) ? inflateBgzf(out, begin, end, threads)
+                                                                            : inflateGzip(out, begin, end);
+    if (stats != nullptr && res)
+    {
+        stats->compressedBytes += end - begin;
+        stats->bytes += out.size();
+        stats->seconds += seqan::sysTime() - start;
+    }
+    return res;
+}
+
+#endif  // DECOMPRESSION_HPP_
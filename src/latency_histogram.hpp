@@ -0,0 +1,177 @@
+// ==========================================================================
+//                 SeqAn - The Library for Sequence Analysis
+// ==========================================================================
+// Copyright (c) 2006-2018, Knut Reinert, FU Berlin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Knut Reinert or the FU Berlin nor the names of
+//       its contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Rene Rahn <rene.rahn@fu-berlin.de>
+// ==========================================================================
+
+#ifndef LATENCY_HISTOGRAM_HPP_
+#define LATENCY_HISTOGRAM_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// Class LatencyHistogram
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class LatencyHistogram
+ * @headerfile latency_histogram.hpp
+ * @brief Log-linear histogram of latencies in nanoseconds with a relative error below 1%.
+ *
+ * Values are bucketed in the style of an HDR histogram: every power of two is split into 128 linear sub-buckets,
+ * i.e. a relative error of at most 1/128, such that the memory footprint is constant and independent of the number
+ * of recorded values.
+ */
+class LatencyHistogram
+{
+public:
+
+    LatencyHistogram() : mCounts(_indexOf(UINT64_MAX) + 1, 0)
+    {}
+
+    inline void record(uint64_t const nanoSeconds)
+    {
+        ++mCounts[_indexOf(nanoSeconds)];
+        ++mTotal;
+        mMax = std::max(mMax, nanoSeconds);
+    }
+
+    inline void reset()
+    {
+        std::fill(mCounts.begin(), mCounts.end(), 0);
+        mTotal = 0;
+        mMax = 0;
+    }
+
+    inline uint64_t count() const
+    {
+        return mTotal;
+    }
+
+    inline uint64_t max() const
+    {
+        return mMax;
+    }
+
+    // Returns the highest value equivalent to the value at the given percentile.
+    inline uint64_t percentile(double const p) const
+    {
+        if (mTotal == 0)
+            return 0;
+
+        uint64_t rank = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(p / 100.0 * mTotal)), 1);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < mCounts.size(); ++i)
+        {
+            seen += mCounts[i];
+            if (seen >= rank)
+                return std::min(_highestEquivalentValue(i), mMax);
+        }
+        return mMax;
+    }
+
+private:
+
+    static constexpr unsigned SUB_BUCKET_BITS = 8;
+
+    static inline size_t _indexOf(uint64_t const value)
+    {
+        if (value < (1u << SUB_BUCKET_BITS))
+            return static_cast<size_t>(value);
+
+        unsigned msb = 63 - __builtin_clzll(value);
+        unsigned shift = msb - SUB_BUCKET_BITS + 1;
+        return (static_cast<size_t>(shift) << (SUB_BUCKET_BITS - 1)) + static_cast<size_t>(value >> shift);
+    }
+
+    static inline uint64_t _highestEquivalentValue(size_t const index)
+    {
+        if (index < (1u << SUB_BUCKET_BITS))
+            return index;
+
+        unsigned shift = static_cast<unsigned>(index >> (SUB_BUCKET_BITS - 1)) - 1;
+        uint64_t sub = index - (static_cast<uint64_t>(shift) << (SUB_BUCKET_BITS - 1));
+        return ((sub + 1) << shift) - 1;
+    }
+
+    std::vector<uint64_t>   mCounts;
+    uint64_t                mTotal{0};
+    uint64_t                mMax{0};
+};
+
+// ----------------------------------------------------------------------------
+// Class LatencyStats
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class LatencyStats
+ * @headerfile latency_histogram.hpp
+ * @brief Completion latencies of the alignments of one batch in seconds.
+ *
+ * The latency of an alignment is the time from the start of the batch until its result is available.
+ * <tt>stragglerTail</tt> is the part of the makespan spent after 99% of the alignments were completed.
+ */
+struct LatencyStats
+{
+    bool    enabled{false};
+    double  p50{0.0};
+    double  p90{0.0};
+    double  p99{0.0};
+    double  p999{0.0};
+    double  makespan{0.0};
+    double  stragglerTail{0.0};
+};
+
+// ============================================================================
+// Functions
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Function computeLatencyStats()
+// ----------------------------------------------------------------------------
+
+inline LatencyStats computeLatencyStats(LatencyHistogram const & histogram)
+{
+    LatencyStats res;
+    res.enabled = true;
+    res.p50 = histogram.percentile(50.0) / 1e9;
+    res.p90 = histogram.percentile(90.0) / 1e9;
+    res.p99 = histogram.percentile(99.0) / 1e9;
+    res.p999 = histogram.percentile(99.9) / 1e9;
+    res.makespan = histogram.max() / 1e9;
+    res.stragglerTail = res.makespan - res.p99;
+    return res;
+}
+
+#endif  // #ifndef LATENCY_HISTOGRAM_HPP_
@@ -0,0 +1,218 @@
+// ==========================================================================
+//                 SeqAn - The Library for Sequence Analysis
+// ==========================================================================
+// Copyright (c) 2006-2018, Knut Reinert, FU Berlin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Knut Reinert or the FU Berlin nor the names of
+//       its contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Rene Rahn <rene.rahn@fu-berlin.de>
+// ==========================================================================
+
+#ifndef MAPPED_FASTA_HPP_
+#define MAPPED_FASTA_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // defined(__unix__) || defined(__APPLE__)
+
+#include <seqan/basic.h>
+#include <seqan/sequence.h>
+
+using namespace seqan;
+
+// ----------------------------------------------------------------------------
+// Class MappedFasta
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class MappedFasta
+ * @headerfile mapped_fasta.hpp
+ * @brief FASTA file read through a read-only memory mapping into one contiguous string of <tt>TAlphabet</tt>.
+ *
+ * @signature template <typename TAlphabet>
+ *            class MappedFasta;
+ *
+ * A single scan over the mapping, which locates the line breaks with <tt>memchr</tt>, builds the record index and
+ * converts the residues of all records back to back into @link MappedFasta#host @endlink. The mapping is released
+ * afterwards. Hence, the residues are copied once into a single allocation instead of one string per record, and
+ * the records are exposed as infixes of the host. The file itself is never modified nor copied as a whole.
+ *
+ * The object can neither be copied nor moved, since the views refer to its host.
+ */
+template <typename TAlphabet>
+class MappedFasta
+{
+public:
+
+    using THost = String<TAlphabet>;
+    using TView = typename Infix<THost const>::Type;
+
+    MappedFasta() = default;
+    MappedFasta(MappedFasta const &) = delete;
+    MappedFasta & operator=(MappedFasta const &) = delete;
+
+    // Maps and indexes the file. Returns false if the file cannot be mapped or is no FASTA file.
+    inline bool
+    open(std::string const & fileName)
+    {
+        close();
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd == -1)
+            return false;
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        size_t const size = info.st_size;
+        void * data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED)
+            return false;
+
+        madvise(data, size, MADV_SEQUENTIAL);
+        bool const ok = index(static_cast<char const *>(data), size);
+        munmap(data, size);
+        if (!ok)
+            close();
+        return ok;
+#else  // defined(__unix__) || defined(__APPLE__)
+        (void)fileName;
+        return false;
+#endif  // defined(__unix__) || defined(__APPLE__)
+    }
+
+    inline void
+    close()
+    {
+        clear(mHost);
+        shrinkToFit(mHost);
+        mNames.clear();
+        mRecords.clear();
+    }
+
+    inline size_t
+    size() const
+    {
+        return mRecords.size();
+    }
+
+    inline THost const &
+    host() const
+    {
+        return mHost;
+    }
+
+    // Returns the residues of the i-th record as view into the host.
+    inline TView
+    operator[](size_t const i) const
+    {
+        return infix(mHost, mRecords[i].begin, mRecords[i].end);
+    }
+
+    // Returns the header of the i-th record without the leading '>'.
+    inline std::string
+    name(size_t const i) const
+    {
+        return mNames.substr(mRecords[i].nameBegin, mRecords[i].nameEnd - mRecords[i].nameBegin);
+    }
+
+private:
+
+    struct Record
+    {
+        size_t  nameBegin;
+        size_t  nameEnd;
+        size_t  begin;
+        size_t  end;
+    };
+
+    // Builds the record index and converts the residues into the host.
+    inline bool
+    index(char const * const data, size_t const size)
+    {
+        // The file size bounds the number of residues, the host is shortened to the residues and its capacity
+        // released afterwards, such that headers and line breaks do not stay allocated.
+        resize(mHost, size, Exact());
+        auto out = begin(mHost, Standard());
+
+        char const * const fileEnd = data + size;
+        char const * line = data;
+        while (line < fileEnd)
+        {
+            char const * lineEnd = static_cast<char const *>(std::memchr(line, '\n', fileEnd - line));
+            if (lineEnd == nullptr)
+                lineEnd = fileEnd;
+            char const * contentEnd = (lineEnd > line && lineEnd[-1] == '\r') ? lineEnd - 1 : lineEnd;
+
+            size_t const residues = out - begin(mHost, Standard());
+            if (*line == '>')
+            {
+                if (!mRecords.empty())
+                    mRecords.back().end = residues;
+                mRecords.push_back(Record{mNames.size(), mNames.size() + (contentEnd - line - 1), residues, residues});
+                mNames.append(line + 1, contentEnd);
+            }
+            else if (mRecords.empty())
+            {
+                if (contentEnd != line)  // Residues before the first header.
+                    return false;
+            }
+            else
+            {
+                for (char const * it = line; it != contentEnd; ++it, ++out)
+                    *out = TAlphabet(*it);
+            }
+            line = lineEnd + 1;
+        }
+
+        size_t const residues = out - begin(mHost, Standard());
+        if (!mRecords.empty())
+            mRecords.back().end = residues;
+        resize(mHost, residues);
+        shrinkToFit(mHost);
+        return !mRecords.empty();
+    }
+
+    THost               mHost;
+    std::string         mNames;
+    std::vector<Record> mRecords;
+};
+
+#endif  // MAPPED_FASTA_HPP_
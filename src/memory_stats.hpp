@@ -0,0 +1,290 @@
+// ==========================================================================
+//                 SeqAn - The Library for Sequence Analysis
+// ==========================================================================
+// Copyright (c) 2006-2018, Knut Reinert, FU Berlin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Knut Reinert or the FU Berlin nor the names of
+//       its contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Rene Rahn <rene.rahn@fu-berlin.de>
+// ==========================================================================
+
+#ifndef MEMORY_STATS_HPP_
+#define MEMORY_STATS_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <string>
+
+// ----------------------------------------------------------------------------
+// Class HeapCounters
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class HeapCounters
+ * @headerfile memory_stats.hpp
+ * @brief Global heap allocation counters, updated by the interposed <tt>operator new</tt>/<tt>operator delete</tt>.
+ *
+ * The counters are only maintained if the binary is built with <tt>ALIGN_BENCH_MEMORY_STATS</tt>.
+ */
+struct HeapCounters
+{
+    std::atomic<uint64_t> allocs{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> live{0};
+    std::atomic<uint64_t> peak{0};
+};
+
+inline HeapCounters & heapCounters()
+{
+    static HeapCounters counters;
+    return counters;
+}
+
+// ----------------------------------------------------------------------------
+// Class MemoryStats
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class MemoryStats
+ * @headerfile memory_stats.hpp
+ * @brief Memory consumption of the timed region.
+ *
+ * <tt>peakRss</tt> is the resident set high-water mark in bytes. <tt>allocs</tt> and <tt>peakHeap</tt> are
+ * the number of heap allocations per run and the peak of the additionally allocated heap bytes and are only
+ * available with <tt>ALIGN_BENCH_MEMORY_STATS</tt>.
+ */
+struct MemoryStats
+{
+    bool        heapTracked{false};
+    uint64_t    peakRss{0};
+    uint64_t    rssGrowth{0};
+    uint64_t    allocs{0};
+    uint64_t    peakHeap{0};
+};
+
+// ============================================================================
+// Functions
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Function readStatusValue()
+// ----------------------------------------------------------------------------
+
+// Reads a value given in kB from /proc/self/status and returns it in bytes, or 0 if unavailable.
+inline uint64_t readStatusValue(std::string const & key)
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, key.size(), key) == 0 && line.size() > key.size() && line[key.size()] == ':')
+            return std::strtoull(line.c_str() + key.size() + 1, nullptr, 10) * 1024;
+    }
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+// Function resetPeakRss()
+// ----------------------------------------------------------------------------
+
+// Resets the high-water mark to the current RSS (Linux >= 4.0). Otherwise the peak covers the whole process.
+inline void resetPeakRss()
+{
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    if (clearRefs.good())
+        clearRefs << "5";
+}
+
+// ----------------------------------------------------------------------------
+// Class MemoryProbe
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class MemoryProbe
+ * @headerfile memory_stats.hpp
+ * @brief Samples RSS and heap counters at the begin and end of a measured region.
+ */
+class MemoryProbe
+{
+public:
+
+    inline void start()
+    {
+        resetPeakRss();
+        mRssBegin = readStatusValue("VmRSS");
+        HeapCounters & counters = heapCounters();
+        mAllocsBegin = counters.allocs.load();
+        mLiveBegin = counters.live.load();
+        counters.peak.store(mLiveBegin);
+    }
+
+    // The heap counters are sampled closest to the region, since reading /proc allocates itself.
+    inline void stop()
+    {
+        HeapCounters & counters = heapCounters();
+        mStats.allocs += counters.allocs.load() - mAllocsBegin;
+        mStats.peakHeap = std::max(mStats.peakHeap, counters.peak.load() - mLiveBegin);
+
+        mStats.peakRss = std::max(mStats.peakRss, readStatusValue("VmHWM"));
+        if (mStats.peakRss > mRssBegin)
+            mStats.rssGrowth = std::max(mStats.rssGrowth, mStats.peakRss - mRssBegin);
+        ++mRuns;
+    }
+
+    inline void reset()
+    {
+        mStats = MemoryStats{};
+        mRuns = 0;
+    }
+
+    inline MemoryStats getStats() const
+    {
+        MemoryStats res = mStats;
+#if defined(ALIGN_BENCH_MEMORY_STATS)
+        res.heapTracked = true;
+#endif  // defined(ALIGN_BENCH_MEMORY_STATS)
+        res.allocs /= std::max(mRuns, 1u);
+        return res;
+    }
+
+private:
+
+    MemoryStats mStats;
+    unsigned    mRuns{0};
+    uint64_t    mRssBegin{0};
+    uint64_t    mAllocsBegin{0};
+    uint64_t    mLiveBegin{0};
+};
+
+// ----------------------------------------------------------------------------
+// Interposed global allocation functions.
+// ----------------------------------------------------------------------------
+
+// Every benchmark binary consists of a single translation unit, such that the replacements below are defined
+// exactly once per program. The requested size is stored in front of the returned memory.
+#if defined(ALIGN_BENCH_MEMORY_STATS)
+
+namespace impl
+{
+namespace memory_stats
+{
+
+constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+
+inline void * allocate(size_t const size)
+{
+    void * ptr = std::malloc(size + HEADER_SIZE);
+    if (ptr == nullptr)
+        return nullptr;
+
+    *static_cast<size_t *>(ptr) = size;
+
+    HeapCounters & counters = heapCounters();
+    counters.allocs.fetch_add(1, std::memory_order_relaxed);
+    counters.bytes.fetch_add(size, std::memory_order_relaxed);
+    uint64_t live = counters.live.fetch_add(size, std::memory_order_relaxed) + size;
+    uint64_t peak = counters.peak.load(std::memory_order_relaxed);
+    while (live > peak && !counters.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    {}
+    return static_cast<char *>(ptr) + HEADER_SIZE;
+}
+
+inline void deallocate(void * ptr)
+{
+    if (ptr == nullptr)
+        return;
+
+    void * base = static_cast<char *>(ptr) - HEADER_SIZE;
+    heapCounters().live.fetch_sub(*static_cast<size_t *>(base), std::memory_order_relaxed);
+    std::free(base);
+}
+
+}  // namespace memory_stats
+}  // namespace impl
+
+void * operator new(size_t size)
+{
+    if (void * ptr = impl::memory_stats::allocate(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void * operator new[](size_t size)
+{
+    if (void * ptr = impl::memory_stats::allocate(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void * operator new(size_t size, std::nothrow_t const &) noexcept
+{
+    return impl::memory_stats::allocate(size);
+}
+
+void * operator new[](size_t size, std::nothrow_t const &) noexcept
+{
+    return impl::memory_stats::allocate(size);
+}
+
+void operator delete(void * ptr) noexcept
+{
+    impl::memory_stats::deallocate(ptr);
+}
+
+void operator delete[](void * ptr) noexcept
+{
+    impl::memory_stats::deallocate(ptr);
+}
+
+void operator delete(void * ptr, size_t) noexcept
+{
+    impl::memory_stats::deallocate(ptr);
+}
+
+void operator delete[](void * ptr, size_t) noexcept
+{
+    impl::memory_stats::deallocate(ptr);
+}
+
+void operator delete(void * ptr, std::nothrow_t const &) noexcept
+{
+    impl::memory_stats::deallocate(ptr);
+}
+
+void operator delete[](void * ptr, std::nothrow_t const &) noexcept
+{
+    impl::memory_stats::deallocate(ptr);
+}
+
+#endif  // defined(ALIGN_BENCH_MEMORY_STATS)
+
+#endif  // #ifndef MEMORY_STATS_HPP_
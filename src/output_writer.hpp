@@ -0,0 +1,477 @@
+// ==========================================================================
+//                 SeqAn - The Library for Sequence Analysis
+// ==========================================================================
+// Copyright (c) 2006-2018, Knut Reinert, FU Berlin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Knut Reinert or the FU Berlin nor the names of
+//       its contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Rene Rahn <rene.rahn@fu-berlin.de>
+// ==========================================================================
+
+#ifndef OUTPUT_WRITER_HPP_
+#define OUTPUT_WRITER_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // defined(__unix__) || defined(__APPLE__)
+
+#include <seqan/parallel.h>
+
+// ============================================================================
+// Tags, Classes, Enums
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Class ScoreFileHeader
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class ScoreFileHeader
+ * @headerfile output_writer.hpp
+ * @brief Header of a binary score file.
+ *
+ * The header is followed by <tt>numScores</tt> scores stored as raw integers of <tt>elementBytes</tt> bytes in the
+ * byte order of the writing machine, which is recorded in <tt>byteOrder</tt>.
+ */
+struct ScoreFileHeader
+{
+    static constexpr char     MAGIC[4] = {'A', 'B', 'S', 'C'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    char     magic[4];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t elementBytes;
+    uint64_t numScores;
+};
+
+constexpr char ScoreFileHeader::MAGIC[4];
+
+// ----------------------------------------------------------------------------
+// Class OutputFile
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class OutputFile
+ * @headerfile output_writer.hpp
+ * @brief Write-only file which collects the output in a large buffer and hands it to the kernel in few large writes.
+ *
+ * @signature class OutputFile;
+ *
+ * The file name <tt>"stdout"</tt> writes to the standard output. If <tt>directIo</tt> is requested and supported by
+ * the file system the file is opened with <tt>O_DIRECT</tt>, bypassing the page cache. The buffer is then aligned
+ * to <tt>DIRECT_ALIGNMENT</tt> and the zero padded last block is truncated on @link OutputFile#close @endlink.
+ */
+class OutputFile
+{
+public:
+
+    static constexpr size_t BUFFER_SIZE = 4 * 1024 * 1024;
+    static constexpr size_t DIRECT_ALIGNMENT = 4096;
+
+    OutputFile() = default;
+    OutputFile(OutputFile const &) = delete;
+    OutputFile & operator=(OutputFile const &) = delete;
+
+    ~OutputFile()
+    {
+        close();
+        std::free(mBuffer);
+    }
+
+    inline bool open(std::string const & fileName, bool const directIo = false)
+    {
+        close();
+        mGood = true;
+        mDirect = false;
+        mWritten = 0;
+        mFill = 0;
+        if (mBuffer == nullptr && posix_memalign(reinterpret_cast<void **>(&mBuffer), DIRECT_ALIGNMENT, BUFFER_SIZE) != 0)
+            mBuffer = nullptr;
+        if (mBuffer == nullptr)
+            return mGood = false;
+
+#if defined(__unix__) || defined(__APPLE__)
+        if (fileName == "stdout")
+        {
+            mFd = STDOUT_FILENO;
+            mOwnsFd = false;
+            return true;
+        }
+
+#if defined(O_DIRECT)
+        if (directIo)
+        {
+            mFd = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+            mDirect = (mFd != -1);
+        }
+#else
+        (void)directIo;
+#endif  // defined(O_DIRECT)
+        // Not every file system supports O_DIRECT, e.g. tmpfs, so fall back to buffered writes.
+        if (mFd == -1)
+            mFd = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        mOwnsFd = true;
+        return mGood = (mFd != -1);
+#else
+        (void)directIo;
+        mFile = (fileName == "stdout") ? stdout : std::fopen(fileName.c_str(), "wb");
+        return mGood = (mFile != nullptr);
+#endif  // defined(__unix__) || defined(__APPLE__)
+    }
+
+    inline bool isOpen() const
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        return mFd != -1;
+#else
+        return mFile != nullptr;
+#endif  // defined(__unix__) || defined(__APPLE__)
+    }
+
+    inline bool isDirect() const
+    {
+        return mDirect;
+    }
+
+    // False if opening or any write failed.
+    inline bool good() const
+    {
+        return mGood && isOpen();
+    }
+
+    // Number of bytes written so far, including the buffered ones.
+    inline uint64_t size() const
+    {
+        return mWritten + mFill;
+    }
+
+    inline void write(char const * data, size_t count)
+    {
+        if (!good())
+            return;
+
+        // Large blocks bypass the buffer unless every write has to be aligned.
+        if (!mDirect && count >= BUFFER_SIZE)
+        {
+            flush();
+            _writeAll(data, count);
+            mWritten += count;
+            return;
+        }
+
+        while (count > 0)
+        {
+            size_t const n = std::min(count, BUFFER_SIZE - mFill);
+            std::memcpy(mBuffer + mFill, data, n);
+            mFill += n;
+            data += n;
+            count -= n;
+            if (mFill == BUFFER_SIZE)
+                flush();
+        }
+    }
+
+    inline void write(std::string const & data)
+    {
+        write(data.data(), data.size());
+    }
+
+    // Writes the buffer. With O_DIRECT only whole blocks are written and the remainder is kept for the next flush.
+    inline void flush()
+    {
+        size_t const count = (mDirect) ? mFill - mFill % DIRECT_ALIGNMENT : mFill;
+        if (count == 0 || !good())
+            return;
+
+        _writeAll(mBuffer, count);
+        mWritten += count;
+        std::memmove(mBuffer, mBuffer + count, mFill - count);
+        mFill -= count;
+    }
+
+    inline bool close()
+    {
+        if (!isOpen())
+            return mGood;
+
+        flush();
+#if defined(__unix__) || defined(__APPLE__)
+        if (mFill > 0)
+        {
+            // Pad the last block for the direct write and cut the padding off afterwards.
+            uint64_t const fileSize = mWritten + mFill;
+            size_t const padded = (mFill + DIRECT_ALIGNMENT - 1) / DIRECT_ALIGNMENT * DIRECT_ALIGNMENT;
+            std::memset(mBuffer + mFill, 0, padded - mFill);
+            _writeAll(mBuffer, padded);
+            mGood = mGood && ftruncate(mFd, fileSize) == 0;
+            mWritten = fileSize;
+            mFill = 0;
+        }
+        if (mOwnsFd)
+            mGood = (::close(mFd) == 0) && mGood;
+        mFd = -1;
+#else
+        if (mFile != stdout)
+            mGood = (std::fclose(mFile) == 0) && mGood;
+        else
+            std::fflush(mFile);
+        mFile = nullptr;
+#endif  // defined(__unix__) || defined(__APPLE__)
+        mDirect = false;
+        return mGood;
+    }
+
+private:
+
+    inline void _writeAll(char const * data, size_t count)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        while (count > 0 && mGood)
+        {
+            ssize_t const n = ::write(mFd, data, count);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+            {
+                mGood = false;
+                break;
+            }
+            data += n;
+            count -= n;
+        }
+#else
+        mGood = mGood && std::fwrite(data, 1, count, mFile) == count;
+#endif  // defined(__unix__) || defined(__APPLE__)
+    }
+
+    char *      mBuffer{nullptr};
+    size_t      mFill{0};
+    uint64_t    mWritten{0};
+    bool        mDirect{false};
+    bool        mGood{true};
+#if defined(__unix__) || defined(__APPLE__)
+    int         mFd{-1};
+    bool        mOwnsFd{false};
+#else
+    std::FILE * mFile{nullptr};
+#endif  // defined(__unix__) || defined(__APPLE__)
+};
+
+constexpr size_t OutputFile::BUFFER_SIZE;
+constexpr size_t OutputFile::DIRECT_ALIGNMENT;
+
+// ============================================================================
+// Functions
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Function formatInteger()
+// ----------------------------------------------------------------------------
+
+/*!
+ * @fn formatInteger
+ * @headerfile output_writer.hpp
+ * @brief Writes the decimal representation of an integer to <tt>out</tt> and returns the end of the written range.
+ *
+ * @signature char * formatInteger(out, value);
+ *
+ * Two digits are emitted per step from a lookup table. <tt>out</tt> must provide room for
+ * <tt>std::numeric_limits<TInteger>::digits10 + 2</tt> characters. No terminating zero is written.
+ */
+template <typename TInteger>
+inline char *
+formatInteger(char * out, TInteger const value)
+{
+    static_assert(std::is_integral<TInteger>::value, "formatInteger expects an integral type.");
+    static char const digitPairs[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+    using TUnsigned = typename std::make_unsigned<TInteger>::type;
+    TUnsigned rest = static_cast<TUnsigned>(value);
+    if (value < 0)
+    {
+        *out++ = '-';
+        rest = static_cast<TUnsigned>(0) - rest;
+    }
+
+    char tmp[std::numeric_limits<TUnsigned>::digits10 + 1];
+    char * pos = tmp + sizeof(tmp);
+    while (rest >= 100)
+    {
+        unsigned const pair = static_cast<unsigned>(rest % 100) * 2;
+        rest /= 100;
+        *--pos = digitPairs[pair + 1];
+        *--pos = digitPairs[pair];
+    }
+    if (rest >= 10)
+    {
+        unsigned const pair = static_cast<unsigned>(rest) * 2;
+        *--pos = digitPairs[pair + 1];
+        *--pos = digitPairs[pair];
+    }
+    else
+    {
+        *--pos = static_cast<char>('0' + rest);
+    }
+
+    size_t const count = tmp + sizeof(tmp) - pos;
+    std::memcpy(out, pos, count);
+    return out + count;
+}
+
+// ----------------------------------------------------------------------------
+// Function appendScoresText()
+// ----------------------------------------------------------------------------
+
+// Appends the scores [first, last) as lines "<score>,".
+template <typename TScores>
+inline void
+appendScoresText(std::string & buffer, TScores const & scores, size_t const first, size_t const last)
+{
+    using TScore = typename std::decay<decltype(scores[0])>::type;
+
+    size_t const offset = buffer.size();
+    buffer.resize(offset + (last - first) * (std::numeric_limits<TScore>::digits10 + 4));
+    char * out = &buffer[offset];
+    for (size_t i = first; i < last; ++i)
+    {
+        out = formatInteger(out, scores[i]);
+        *out++ = ',';
+        *out++ = '\n';
+    }
+    buffer.resize(out - buffer.data());
+}
+
+// ----------------------------------------------------------------------------
+// Function writeOrderedChunks()
+// ----------------------------------------------------------------------------
+
+/*!
+ * @fn writeOrderedChunks
+ * @headerfile output_writer.hpp
+ * @brief Formats the records <tt>[0, count)</tt> in chunks on <tt>threads</tt> threads and writes them in order.
+ *
+ * @signature void writeOrderedChunks(file, count, chunkSize, threads, format);
+ *
+ * @param file      The @link OutputFile @endlink to write to.
+ * @param count     The number of records.
+ * @param chunkSize The number of records formatted by one task.
+ * @param threads   The number of formatting threads.
+ * @param format    Callable <tt>format(buffer, first, last)</tt> appending the records <tt>[first, last)</tt> to
+ *                  the <tt>std::string</tt> buffer.
+ *
+ * Every round formats one chunk per thread into the thread's own buffer and then writes the buffers in the order of
+ * the chunks, such that the memory is bounded by <tt>threads</tt> formatted chunks.
+ */
+template <typename TFormat>
+inline void
+writeOrderedChunks(OutputFile & file,
+                   size_t const count,
+                   size_t const chunkSize,
+                   unsigned const threads,
+                   TFormat && format)
+{
+    size_t const chunk = std::max<size_t>(chunkSize, 1);
+    size_t const numChunks = (count + chunk - 1) / chunk;
+    size_t const numBuffers = std::max(std::min<size_t>(threads, numChunks), static_cast<size_t>(1));
+    std::vector<std::string> buffers(numBuffers);
+
+    for (size_t round = 0; round < numChunks && file.good(); round += numBuffers)
+    {
+        size_t const roundChunks = std::min(numBuffers, numChunks - round);
+        SEQAN_OMP_PRAGMA(parallel for schedule(static, 1) num_threads(numBuffers))
+        for (int64_t t = 0; t < static_cast<int64_t>(roundChunks); ++t)
+        {
+            size_t const first = (round + t) * chunk;
+            buffers[t].clear();
+            format(buffers[t], first, std::min(first + chunk, count));
+        }
+
+        for (size_t t = 0; t < roundChunks; ++t)
+            file.write(buffers[t]);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Function writeScoresText()
+// ----------------------------------------------------------------------------
+
+// One score per line followed by a comma and a final empty line.
+template <typename TScores>
+inline bool
+writeScoresText(OutputFile & file, TScores const & scores, unsigned const threads)
+{
+    writeOrderedChunks(file, scores.size(), 1u << 16, threads, [&] (std::string & buffer, size_t first, size_t last)
+    {
+        appendScoresText(buffer, scores, first, last);
+    });
+    file.write("\n", 1);
+    return file.good();
+}
+
+// ----------------------------------------------------------------------------
+// Function writeScoresBinary()
+// ----------------------------------------------------------------------------
+
+// A ScoreFileHeader followed by the raw scores.
+template <typename TScore>
+inline bool
+writeScoresBinary(OutputFile & file, std::vector<TScore> const & scores)
+{
+    static_assert(std::is_integral<TScore>::value, "Binary scores must be integers.");
+
+    ScoreFileHeader header;
+    std::memcpy(header.magic, ScoreFileHeader::MAGIC, sizeof(header.magic));
+    header.version = ScoreFileHeader::VERSION;
+    header.byteOrder = ScoreFileHeader::BYTE_ORDER_MARK;
+    header.elementBytes = sizeof(TScore);
+    header.numScores = scores.size();
+
+    file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    if (!scores.empty())
+        file.write(reinterpret_cast<char const *>(scores.data()), scores.size() * sizeof(TScore));
+    return file.good();
+}
+
+#endif  // OUTPUT_WRITER_HPP_
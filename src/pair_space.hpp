@@ -0,0 +1,289 @@
+// ==========================================================================
+//                 SeqAn - The Library for Sequence Analysis
+// ==========================================================================
+// Copyright (c) 2006-2018, Knut Reinert, FU Berlin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Knut Reinert or the FU Berlin nor the names of
+//       its contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Rene Rahn <rene.rahn@fu-berlin.de>
+// ==========================================================================
+
+#ifndef PAIR_SPACE_HPP_
+#define PAIR_SPACE_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+#include <seqan/basic.h>
+#include <seqan/parallel.h>
+#include <seqan/sequence.h>
+
+#include "align_bench_options.hpp"
+
+using namespace seqan;
+
+// ----------------------------------------------------------------------------
+// Class PairSpace
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class PairSpace
+ * @headerfile pair_space.hpp
+ * @brief Maps the index of an alignment to the records it aligns.
+ *
+ * For the <i>pair</i> mode the k-th alignment aligns the k-th records of both sets, for the <i>search</i> mode
+ * the records <tt>(k / n2, k % n2)</tt> and for the <i>OLC</i> mode the k-th pair <tt>(i, j)</tt> with
+ * <tt>i < j</tt> in row-major order, whose row is computed in closed form. The pairs can be replicated, which
+ * repeats the whole space.
+ */
+class PairSpace
+{
+public:
+
+    PairSpace() = default;
+
+    PairSpace(AlignmentMode const mode, size_t const n1, size_t const n2, size_t const replicas = 1) :
+        mMode(mode),
+        mN1(n1),
+        mN2(n2),
+        mReplicas(replicas)
+    {
+        switch (mMode)
+        {
+            case AlignmentMode::PAIR:   mSize = std::min(n1, n2); break;
+            case AlignmentMode::SEARCH: mSize = n1 * n2; break;
+            case AlignmentMode::OLC:    mSize = (n1 < 2) ? 0 : n1 * (n1 - 1) / 2; break;
+        }
+    }
+
+    inline AlignmentMode
+    mode() const
+    {
+        return mMode;
+    }
+
+    // Number of alignments including the replicas.
+    inline size_t
+    size() const
+    {
+        return mSize * mReplicas;
+    }
+
+    inline PairSpace
+    replicated(size_t const replicas) const
+    {
+        return PairSpace(mMode, mN1, mN2, mReplicas * replicas);
+    }
+
+    // Returns the records (i, j) aligned by the k-th alignment.
+    inline std::pair<size_t, size_t>
+    operator()(size_t k) const
+    {
+        k %= mSize;
+        switch (mMode)
+        {
+            case AlignmentMode::SEARCH:
+                return {k / mN2, k % mN2};
+            case AlignmentMode::OLC:
+            {
+                // Row i holds the n - 1 - i pairs starting at rowBegin(i) = i * (2n - i - 1) / 2.
+                auto rowBegin = [&](size_t const i) { return i * (2 * mN1 - i - 1) / 2; };
+                long double const b = 2.0L * mN1 - 1;
+                size_t i = static_cast<size_t>(std::max(0.0L, (b - std::sqrt(b * b - 8.0L * k)) / 2));
+                i = std::min(i, mN1 - 2);
+                while (i > 0 && rowBegin(i) > k)
+                    --i;
+                while (i + 2 < mN1 && rowBegin(i + 1) <= k)
+                    ++i;
+                return {i, i + 1 + k - rowBegin(i)};
+            }
+            default:
+                return {k, k};
+        }
+    }
+
+private:
+
+    AlignmentMode   mMode{AlignmentMode::PAIR};
+    size_t          mN1{0};
+    size_t          mN2{0};
+    size_t          mReplicas{1};
+    size_t          mSize{0};
+};
+
+// ----------------------------------------------------------------------------
+// Class LazyPairSet
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class LazyPairSet
+ * @headerfile pair_space.hpp
+ * @brief One side of the alignments of a @link PairSpace @endlink, whose sequences are looked up on demand.
+ *
+ * @signature template <typename TView>
+ *            class LazyPairSet;
+ *
+ * The k-th element is the horizontal or vertical record of the k-th alignment, returned as reference into the
+ * records. Thus, the alignments of the <i>search</i> and <i>OLC</i> modes need no memory beyond the records.
+ * The sets are materialized in batches by the @link BenchmarkExecutor @endlink, since the alignment interface
+ * requires string sets.
+ */
+template <typename TView>
+class LazyPairSet
+{
+public:
+
+    LazyPairSet() = default;
+
+    LazyPairSet(StringSet<TView> const & records, PairSpace const & space, bool const isVertical) :
+        mRecords(&records),
+        mSpace(space),
+        mIsVertical(isVertical)
+    {}
+
+    inline size_t
+    size() const
+    {
+        return mSpace.size();
+    }
+
+    inline PairSpace const &
+    space() const
+    {
+        return mSpace;
+    }
+
+    inline LazyPairSet
+    replicated(size_t const replicas) const
+    {
+        return LazyPairSet(*mRecords, mSpace.replicated(replicas), mIsVertical);
+    }
+
+    inline TView const &
+    operator[](size_t const k) const
+    {
+        auto const pair = mSpace(k);
+        return (*mRecords)[(mIsVertical) ? pair.second : pair.first];
+    }
+
+private:
+
+    StringSet<TView> const *    mRecords{nullptr};
+    PairSpace                   mSpace;
+    bool                        mIsVertical{false};
+};
+
+namespace seqan
+{
+
+template <typename TView>
+struct Value<LazyPairSet<TView> >
+{
+    using Type = TView;
+};
+
+}  // namespace seqan
+
+// ============================================================================
+// Functions
+// ============================================================================
+
+template <typename TView>
+inline size_t
+length(LazyPairSet<TView> const & set)
+{
+    return set.size();
+}
+
+// ----------------------------------------------------------------------------
+// Function materialize()
+// ----------------------------------------------------------------------------
+
+// Replaces target by the elements [first, last) of the lazy set.
+template <typename TView>
+inline void
+materialize(StringSet<TView> & target, LazyPairSet<TView> const & set, size_t const first, size_t const last)
+{
+    clear(target);
+    reserve(target, last - first, Exact());
+    for (size_t k = first; k < last; ++k)
+        appendValue(target, set[k]);
+}
+
+// ----------------------------------------------------------------------------
+// Function pairSpaceCells()
+// ----------------------------------------------------------------------------
+
+/*!
+ * @fn pairSpaceCells
+ * @brief Number of DP cells of all unbanded alignments of a @link PairSpace @endlink.
+ *
+ * @signature double pairSpaceCells(space, records1, records2)
+ *
+ * Computed in closed form from the sums of the matrix dimensions <tt>1 + |s|</tt>, which takes time linear in
+ * the number of records: the <i>search</i> mode sums to <tt>S1 * S2</tt> and the <i>OLC</i> mode to
+ * <tt>(S1^2 - Q1) / 2</tt>, where <tt>Q1</tt> is the sum of the squared dimensions.
+ */
+template <typename TRecords1, typename TRecords2>
+inline double
+pairSpaceCells(PairSpace const & space, TRecords1 const & records1, TRecords2 const & records2)
+{
+    auto dim = [](auto const & seq) { return 1.0 + length(seq); };
+
+    double sum1 = 0;
+    double squares1 = 0;
+    for (size_t i = 0; i < length(records1); ++i)
+    {
+        sum1 += dim(records1[i]);
+        squares1 += dim(records1[i]) * dim(records1[i]);
+    }
+    double sum2 = 0;
+    for (size_t j = 0; j < length(records2); ++j)
+        sum2 += dim(records2[j]);
+
+    double res = 0;
+    switch (space.mode())
+    {
+        case AlignmentMode::PAIR:
+            for (size_t i = 0; i < std::min<size_t>(length(records1), length(records2)); ++i)
+                res += dim(records1[i]) * dim(records2[i]);
+            break;
+        case AlignmentMode::SEARCH:
+            res = sum1 * sum2;
+            break;
+        case AlignmentMode::OLC:
+            res = (sum1 * sum1 - squares1) / 2;
+            break;
+    }
+    // The replicas repeat the cells of the space.
+    size_t const base = PairSpace(space.mode(), length(records1), length(records2)).size();
+    return (base == 0) ? 0 : res * (space.size() / base);
+}
+
+#endif  // PAIR_SPACE_HPP_
@@ -0,0 +1,369 @@
+// ==========================================================================
+//                 SeqAn - The Library for Sequence Analysis
+// ==========================================================================
+// Copyright (c) 2006-2018, Knut Reinert, FU Berlin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Knut Reinert or the FU Berlin nor the names of
+//       its contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Rene Rahn <rene.rahn@fu-berlin.de>
+// ==========================================================================
+
+#ifndef PARALLEL_READER_HPP_
+#define PARALLEL_READER_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // defined(__unix__) || defined(__APPLE__)
+
+#include <seqan/basic.h>
+#include <seqan/parallel.h>
+#include <seqan/seq_io.h>
+#include <seqan/sequence.h>
+
+#include "decompression.hpp"
+#include "sequence_database.hpp"
+
+using namespace seqan;
+
+namespace impl
+{
+namespace parallel_reader
+{
+
+// ----------------------------------------------------------------------------
+// Class Chunk
+// ----------------------------------------------------------------------------
+
+// A byte range of the file that starts at a record start and the index of its first record.
+struct Chunk
+{
+    char const *    begin;
+    char const *    end;
+    size_t          firstRecord;
+    size_t          numRecords;
+};
+
+// ============================================================================
+// Functions
+// ============================================================================
+
+inline char const *
+nextLine(char const * it, char const * end)
+{
+    char const * lineEnd = static_cast<char const *>(std::memchr(it, '\n', end - it));
+    return (lineEnd == nullptr) ? end : lineEnd + 1;
+}
+
+// Returns the first FASTQ record start at or behind the line start it. A line starting with '@' might as well be a
+// quality line, but only a header is followed by a '+' line two lines later. Other lines, e.g. blank ones, are
+// skipped.
+inline char const *
+nextFastqRecord(char const * it, char const * end)
+{
+    for (; it < end; it = nextLine(it, end))
+    {
+        if (*it == '@')
+        {
+            char const * plusLine = nextLine(nextLine(it, end), end);
+            if (plusLine < end && *plusLine == '+')
+                return it;
+        }
+    }
+    return end;
+}
+
+// Returns the first record start at or behind it. Every '>' at a line start begins a FASTA record, FASTQ records
+// are found by nextFastqRecord().
+inline char const *
+resync(char const * fileBegin, char const * it, char const * end, bool const isFastq)
+{
+    if (it != fileBegin && it[-1] != '\n')
+        it = nextLine(it, end);
+
+    if (isFastq)
+        return nextFastqRecord(it, end);
+
+    while (it < end && *it != '>')
+        it = nextLine(it, end);
+    return it;
+}
+
+// Returns the start of the line behind the four lines of the FASTQ record at it.
+inline char const *
+skipFastqRecord(char const * it, char const * end)
+{
+    for (unsigned line = 0; line < 4; ++line)
+        it = nextLine(it, end);
+    return it;
+}
+
+// Counts the records of a chunk the way parseChunk() walks them.
+inline size_t
+countRecords(Chunk const & chunk, bool const isFastq)
+{
+    size_t records = 0;
+    if (isFastq)
+    {
+        for (char const * it = nextFastqRecord(chunk.begin, chunk.end); it < chunk.end; ++records)
+            it = nextFastqRecord(skipFastqRecord(it, chunk.end), chunk.end);
+        return records;
+    }
+
+    for (char const * it = chunk.begin; it < chunk.end; it = nextLine(it, chunk.end))
+        records += (*it == '>');
+    return records;
+}
+
+// Appends the residues of [it, end) to seq, skipping line breaks and blanks.
+template <typename TSequence>
+inline void
+appendResidues(TSequence & seq, char const * it, char const * end)
+{
+    using TAlphabet = typename Value<TSequence>::Type;
+    for (; it != end; ++it)
+    {
+        char const c = *it;
+        if (c != '\n' && c != '\r' && c != ' ' && c != '\t')
+            appendValue(seq, TAlphabet(c), Generous());
+    }
+}
+
+inline char const *
+lineContentEnd(char const * lineBegin, char const * lineEnd)
+{
+    while (lineEnd > lineBegin && (lineEnd[-1] == '\n' || lineEnd[-1] == '\r'))
+        --lineEnd;
+    return lineEnd;
+}
+
+template <typename TNames, typename TSeqs>
+inline void
+parseChunk(TNames & names, TSeqs & seqs, Chunk const & chunk, bool const isFastq)
+{
+    size_t record = chunk.firstRecord;
+    char const * it = (isFastq) ? nextFastqRecord(chunk.begin, chunk.end) : chunk.begin;
+    while (it < chunk.end)
+    {
+        char const * headerEnd = nextLine(it, chunk.end);
+        assign(names[record], std::string(it + 1, lineContentEnd(it + 1, headerEnd)));
+
+        char const * seqBegin = headerEnd;
+        char const * seqEnd = seqBegin;
+        if (isFastq)
+        {
+            seqEnd = nextLine(seqBegin, chunk.end);
+            it = nextFastqRecord(skipFastqRecord(it, chunk.end), chunk.end);
+        }
+        else
+        {
+            // The sequence ends at the next line starting with '>'.
+            while (seqEnd < chunk.end && *seqEnd != '>')
+                seqEnd = nextLine(seqEnd, chunk.end);
+            it = seqEnd;
+        }
+
+        reserve(seqs[record], seqEnd - seqBegin, Exact());
+        appendResidues(seqs[record], seqBegin, seqEnd);
+        ++record;
+    }
+}
+
+}  // namespace parallel_reader
+}  // namespace impl
+
+// ----------------------------------------------------------------------------
+// Function readRecordsParallel()
+// ----------------------------------------------------------------------------
+
+/*!
+ * @fn readRecordsParallel
+ * @brief Reads all records of FASTA or FASTQ data with multiple threads.
+ *
+ * @signature bool readRecordsParallel(names, seqs, begin, end, threads)
+ * @signature bool readRecordsParallel(names, seqs, fileName, threads[, stats])
+ *
+ * The data is split into one byte range per thread. Every range is moved to the next record start, which for
+ * FASTQ is a '@' line followed by a '+' line two lines later, hence FASTQ records must consist of four lines.
+ * Blank lines between FASTQ records, e.g. at the end of the file, are skipped.
+ * A first parallel pass counts the records of every range, such that a second parallel pass can parse and
+ * convert the records of every range directly to their final position. The records keep the order of the input.
+ *
+ * Files are mapped into memory. Gzip compressed files are decompressed first, see @link decompress @endlink,
+ * and the decompression is added to <tt>stats</tt> if given.
+ * Returns false if the input cannot be read or is neither FASTA nor FASTQ.
+ */
+template <typename TNames, typename TSeqs>
+inline bool
+readRecordsParallel(TNames & names,
+                    TSeqs & seqs,
+                    char const * const begin,
+                    char const * const end,
+                    unsigned const threads)
+{
+    using namespace impl::parallel_reader;
+
+    bool const isFastq = (begin != end && *begin == '@');
+    if (begin == end || (*begin != '>' && !isFastq))
+        return false;
+
+    // Splits the data into ranges beginning at record starts. Consecutive ranges might be empty.
+    size_t const size = end - begin;
+    std::vector<Chunk> chunks(std::max(threads, 1u));
+    for (size_t i = 0; i < chunks.size(); ++i)
+        chunks[i].begin = resync(begin, begin + i * size / chunks.size(), end, isFastq);
+    for (size_t i = 0; i < chunks.size(); ++i)
+        chunks[i].end = (i + 1 < chunks.size()) ? std::max(chunks[i].begin, chunks[i + 1].begin) : end;
+
+    SEQAN_OMP_PRAGMA(parallel for schedule(static, 1) num_threads(chunks.size()))
+    for (int64_t i = 0; i < static_cast<int64_t>(chunks.size()); ++i)
+        chunks[i].numRecords = countRecords(chunks[i], isFastq);
+
+    size_t numRecords = 0;
+    for (auto & chunk : chunks)
+    {
+        chunk.firstRecord = numRecords;
+        numRecords += chunk.numRecords;
+    }
+
+    clear(names);
+    clear(seqs);
+    resize(names, numRecords, Exact());
+    resize(seqs, numRecords, Exact());
+
+    SEQAN_OMP_PRAGMA(parallel for schedule(static, 1) num_threads(chunks.size()))
+    for (int64_t i = 0; i < static_cast<int64_t>(chunks.size()); ++i)
+        parseChunk(names, seqs, chunks[i], isFastq);
+    return true;
+}
+
+template <typename TNames, typename TSeqs>
+inline bool
+readRecordsParallel(TNames & names,
+                    TSeqs & seqs,
+                    std::string const & fileName,
+                    unsigned const threads,
+                    DecompressionStats * stats = nullptr)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd == -1)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    size_t const size = info.st_size;
+    void * data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+        return false;
+
+    char const * const begin = static_cast<char const *>(data);
+    bool res = false;
+    if (isGzip(begin, begin + size))
+    {
+        std::vector<char> buffer;
+        res = decompress(buffer, begin, begin + size, threads, stats) &&
+              readRecordsParallel(names, seqs, buffer.data(), buffer.data() + buffer.size(), threads);
+    }
+    else
+    {
+        res = readRecordsParallel(names, seqs, begin, begin + size, threads);
+    }
+    munmap(data, size);
+    return res;
+#else  // defined(__unix__) || defined(__APPLE__)
+    (void)names;
+    (void)seqs;
+    (void)fileName;
+    (void)threads;
+    (void)stats;
+    return false;
+#endif  // defined(__unix__) || defined(__APPLE__)
+}
+
+// ----------------------------------------------------------------------------
+// Function isGzipFile()
+// ----------------------------------------------------------------------------
+
+inline bool
+isGzipFile(std::string const & fileName)
+{
+    char magic[18] = {};
+    std::ifstream file(fileName, std::ios::binary);
+    file.read(magic, sizeof(magic));
+    return isGzip(magic, magic + file.gcount());
+}
+
+// ----------------------------------------------------------------------------
+// Function readSequences()
+// ----------------------------------------------------------------------------
+
+// Reads all records of a file with readRecordsParallel() or, for a single thread and uncompressed input, with
+// SeqAn's readRecords(). Binary sequence databases are copied with readSequenceDatabase().
+// Returns false if the file could not be read.
+template <typename TNames, typename TSeqs>
+inline bool
+readSequences(TNames & names,
+              TSeqs & seqs,
+              std::string const & fileName,
+              unsigned const threads,
+              DecompressionStats * stats = nullptr)
+{
+    if (isSequenceDatabaseFile(fileName))
+        return readSequenceDatabase(names, seqs, fileName);
+    if (threads > 1 || isGzipFile(fileName))
+        return readRecordsParallel(names, seqs, fileName, threads, stats);
+
+    try
+    {
+        SeqFileIn file{fileName.c_str()};
+        readRecords(names, seqs, file);
+    }
+    catch (std::exception & e)
+    {
+        std::cerr << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+#endif  // PARALLEL_READER_HPP_
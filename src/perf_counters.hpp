@@ -0,0 +1,299 @@
+// ==========================================================================
+//                 SeqAn - The Library for Sequence Analysis
+// ==========================================================================
+// Copyright (c) 2006-2018, Knut Reinert, FU Berlin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Knut Reinert or the FU Berlin nor the names of
+//       its contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Rene Rahn <rene.rahn@fu-berlin.de>
+// ==========================================================================
+
+#ifndef PERF_COUNTERS_HPP_
+#define PERF_COUNTERS_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // defined(__linux__)
+
+// ----------------------------------------------------------------------------
+// Enum PerfEvent
+// ----------------------------------------------------------------------------
+
+enum class PerfEvent : uint8_t
+{
+    CYCLES,
+    INSTRUCTIONS,
+    L1D_MISSES,
+    LLC_MISSES,
+    BRANCH_MISSES,
+    COUNT
+};
+
+// ----------------------------------------------------------------------------
+// Class PerfCounterValues
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class PerfCounterValues
+ * @headerfile perf_counters.hpp
+ * @brief Hardware event counts of one measured region. Negative values mark unavailable events.
+ */
+struct PerfCounterValues
+{
+    std::array<double, static_cast<size_t>(PerfEvent::COUNT)> values;
+
+    PerfCounterValues()
+    {
+        values.fill(-1.0);
+    }
+
+    inline double operator[](PerfEvent const event) const
+    {
+        return values[static_cast<size_t>(event)];
+    }
+
+    inline double & operator[](PerfEvent const event)
+    {
+        return values[static_cast<size_t>(event)];
+    }
+
+    inline bool isAvailable(PerfEvent const event) const
+    {
+        return (*this)[event] >= 0.0;
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Class PerfCounters
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class PerfCounters
+ * @headerfile perf_counters.hpp
+ * @brief Counts hardware events of the calling process via <tt>perf_event_open</tt>.
+ *
+ * The events are opened with <tt>inherit</tt> set, such that threads spawned after @link PerfCounters#open @endlink
+ * are counted as well. Hence the counters must be opened before the first alignment creates the worker threads.
+ * Each event is opened separately, since the kernel does not support reading inherited event groups.
+ * Events that are not supported by the CPU or not permitted by <tt>perf_event_paranoid</tt> stay unavailable.
+ */
+class PerfCounters
+{
+public:
+
+    PerfCounters()
+    {
+        mFds.fill(-1);
+    }
+
+    PerfCounters(PerfCounters const &) = delete;
+    PerfCounters & operator=(PerfCounters const &) = delete;
+
+    ~PerfCounters()
+    {
+        close();
+    }
+
+    inline bool open();
+    inline void close();
+    inline void start();
+    inline void stop();
+
+    // Returns the counts accumulated over all start()/stop() pairs since the last reset().
+    inline PerfCounterValues getValues(unsigned const runs = 1) const;
+
+    inline void reset()
+    {
+        mTotals.fill(0.0);
+    }
+
+    inline bool isOpen() const
+    {
+        for (int fd : mFds)
+            if (fd != -1)
+                return true;
+        return false;
+    }
+
+private:
+
+    static constexpr size_t NUM_EVENTS = static_cast<size_t>(PerfEvent::COUNT);
+
+    struct Reading
+    {
+        uint64_t value;
+        uint64_t timeEnabled;
+        uint64_t timeRunning;
+    };
+
+    inline bool read(size_t const i, Reading & reading) const;
+
+    std::array<int, NUM_EVENTS>     mFds;
+    std::array<Reading, NUM_EVENTS> mBegin;
+    std::array<double, NUM_EVENTS>  mTotals{};
+};
+
+// ============================================================================
+// Functions
+// ============================================================================
+
+#if defined(__linux__)
+
+inline bool
+PerfCounters::open()
+{
+    auto cacheConfig = [](uint64_t const cache, uint64_t const op, uint64_t const result)
+    {
+        return cache | (op << 8) | (result << 16);
+    };
+
+    std::array<std::pair<uint32_t, uint64_t>, NUM_EVENTS> events
+    {{
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, cacheConfig(PERF_COUNT_HW_CACHE_L1D,
+                                         PERF_COUNT_HW_CACHE_OP_READ,
+                                         PERF_COUNT_HW_CACHE_RESULT_MISS)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}
+    }};
+
+    for (size_t i = 0; i < NUM_EVENTS; ++i)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = events[i].first;
+        attr.config = events[i].second;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        mFds[i] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+    reset();
+    return isOpen();
+}
+
+inline void
+PerfCounters::close()
+{
+    for (int & fd : mFds)
+    {
+        if (fd != -1)
+            ::close(fd);
+        fd = -1;
+    }
+}
+
+inline bool
+PerfCounters::read(size_t const i, Reading & reading) const
+{
+    return mFds[i] != -1 && ::read(mFds[i], &reading, sizeof(Reading)) == static_cast<ssize_t>(sizeof(Reading));
+}
+
+inline void
+PerfCounters::start()
+{
+    for (size_t i = 0; i < NUM_EVENTS; ++i)
+    {
+        if (mFds[i] == -1)
+            continue;
+        ioctl(mFds[i], PERF_EVENT_IOC_ENABLE, 0);
+        if (!read(i, mBegin[i]))
+            mBegin[i] = Reading{0, 0, 0};
+    }
+}
+
+inline void
+PerfCounters::stop()
+{
+    for (size_t i = 0; i < NUM_EVENTS; ++i)
+    {
+        Reading end;
+        if (!read(i, end))
+            continue;
+        ioctl(mFds[i], PERF_EVENT_IOC_DISABLE, 0);
+
+        // Scale the count if the event was multiplexed with other events.
+        double value = static_cast<double>(end.value - mBegin[i].value);
+        uint64_t running = end.timeRunning - mBegin[i].timeRunning;
+        uint64_t enabled = end.timeEnabled - mBegin[i].timeEnabled;
+        if (running > 0 && running < enabled)
+            value *= static_cast<double>(enabled) / running;
+        mTotals[i] += value;
+    }
+}
+
+#else  // defined(__linux__)
+
+inline bool PerfCounters::open() { return false; }
+inline void PerfCounters::close() {}
+inline bool PerfCounters::read(size_t const, Reading &) const { return false; }
+inline void PerfCounters::start() {}
+inline void PerfCounters::stop() {}
+
+#endif  // defined(__linux__)
+
+inline PerfCounterValues
+PerfCounters::getValues(unsigned const runs) const
+{
+    PerfCounterValues res;
+    for (size_t i = 0; i < NUM_EVENTS; ++i)
+    {
+        if (mFds[i] != -1)
+            res.values[i] = mTotals[i] / std::max(runs, 1u);
+    }
+    return res;
+}
+
+// ----------------------------------------------------------------------------
+// Function processPerfCounters()
+// ----------------------------------------------------------------------------
+
+// Process-wide counters, opened on first use before any worker thread is spawned by an alignment.
+inline PerfCounters &
+processPerfCounters()
+{
+    static PerfCounters counters;
+    static bool isOpened = counters.open();
+    (void)isOpened;
+    return counters;
+}
+
+#endif  // #ifndef PERF_COUNTERS_HPP_
@@ -0,0 +1,192 @@
+// ==========================================================================
+//                 SeqAn - The Library for Sequence Analysis
+// ==========================================================================
+// Copyright (c) 2006-2018, Knut Reinert, FU Berlin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Knut Reinert or the FU Berlin nor the names of
+//       its contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Rene Rahn <rene.rahn@fu-berlin.de>
+// ==========================================================================
+
+#ifndef PHASE_TIMER_HPP_
+#define PHASE_TIMER_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <seqan/basic.h>
+
+// ----------------------------------------------------------------------------
+// Enum Phase
+// ----------------------------------------------------------------------------
+
+enum class Phase : uint8_t
+{
+    READ,       // Reading or simulating the sequences.
+    PAIRS,      // Building the alignment pairs: sorting, infix and gaps construction.
+    DP,         // Score computation of one timed pass.
+    TRACEBACK,  // Traceback of one timed pass.
+    OUTPUT,     // Writing scores or alignments.
+    COUNT
+};
+
+// ----------------------------------------------------------------------------
+// Class PhaseProfile
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class PhaseProfile
+ * @headerfile phase_timer.hpp
+ * @brief Wall time spent in the phases of a benchmark run.
+ *
+ * Phases can be nested. The time of a nested phase is only accounted to the nested phase and not to the
+ * enclosing one, such that the phases add up to the end-to-end time. A phase that was never entered is reported
+ * as not measured.
+ */
+class PhaseProfile
+{
+public:
+
+    PhaseProfile()
+    {
+        mTimes.fill(-1.0);
+    }
+
+    inline void
+    begin(Phase const phase)
+    {
+        mOpen.push_back(OpenPhase{phase, seqan::sysTime(), 0.0});
+    }
+
+    inline void
+    end()
+    {
+        SEQAN_ASSERT_NOT(mOpen.empty());
+        OpenPhase const closed = mOpen.back();
+        mOpen.pop_back();
+
+        double const elapsed = seqan::sysTime() - closed.begin;
+        add(closed.phase, elapsed - closed.nested);
+        if (!mOpen.empty())
+            mOpen.back().nested += elapsed;
+    }
+
+    // Accounts time that was measured elsewhere, e.g. the mean of the timed kernel passes.
+    inline void
+    add(Phase const phase, double const seconds)
+    {
+        double & value = mTimes[static_cast<uint8_t>(phase)];
+        value = std::max(value, 0.0) + seconds;
+    }
+
+    // Adds the measured phases of another profile.
+    inline PhaseProfile &
+    operator+=(PhaseProfile const & other)
+    {
+        for (uint8_t i = 0; i < static_cast<uint8_t>(Phase::COUNT); ++i)
+            if (other.mTimes[i] >= 0.0)
+                add(static_cast<Phase>(i), other.mTimes[i]);
+        return *this;
+    }
+
+    inline void
+    reset(Phase const phase)
+    {
+        mTimes[static_cast<uint8_t>(phase)] = -1.0;
+    }
+
+    inline bool
+    isMeasured(Phase const phase) const
+    {
+        return mTimes[static_cast<uint8_t>(phase)] >= 0.0;
+    }
+
+    inline double
+    operator[](Phase const phase) const
+    {
+        return std::max(mTimes[static_cast<uint8_t>(phase)], 0.0);
+    }
+
+    // Sum of all measured phases.
+    inline double
+    total() const
+    {
+        double sum = 0.0;
+        for (double value : mTimes)
+            sum += std::max(value, 0.0);
+        return sum;
+    }
+
+private:
+
+    struct OpenPhase
+    {
+        Phase   phase;
+        double  begin;
+        double  nested;
+    };
+
+    std::array<double, static_cast<uint8_t>(Phase::COUNT)> mTimes;
+    std::vector<OpenPhase> mOpen;
+};
+
+// ----------------------------------------------------------------------------
+// Class ScopedPhase
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class ScopedPhase
+ * @headerfile phase_timer.hpp
+ * @brief Accounts the lifetime of the object to a phase of a @link PhaseProfile @endlink.
+ *
+ * @signature ScopedPhase scope(profile, Phase::OUTPUT);
+ */
+class ScopedPhase
+{
+public:
+
+    ScopedPhase(PhaseProfile & profile, Phase const phase) : mProfile(profile)
+    {
+        mProfile.begin(phase);
+    }
+
+    ScopedPhase(ScopedPhase const &) = delete;
+    ScopedPhase & operator=(ScopedPhase const &) = delete;
+
+    ~ScopedPhase()
+    {
+        mProfile.end();
+    }
+
+private:
+
+    PhaseProfile & mProfile;
+};
+
+#endif  // PHASE_TIMER_HPP_
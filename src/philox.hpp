@@ -0,0 +1,260 @@
+// ==========================================================================
+//                 SeqAn - The Library for Sequence Analysis
+// ==========================================================================
+// Copyright (c) 2006-2018, Knut Reinert, FU Berlin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Knut Reinert or the FU Berlin nor the names of
+//       its contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Rene Rahn <rene.rahn@fu-berlin.de>
+// ==========================================================================
+
+#ifndef PHILOX_HPP_
+#define PHILOX_HPP_
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+// ----------------------------------------------------------------------------
+// Function philox4x32()
+// ----------------------------------------------------------------------------
+
+/*!
+ * @fn philox4x32
+ * @headerfile philox.hpp
+ * @brief The Philox4x32-10 counter-based bijection of Salmon et al. (SC'11).
+ *
+ * @signature std::array<uint32_t, 4> philox4x32(counter, key);
+ *
+ * Maps a 128 bit counter and a 64 bit key to 128 random bits. Since every block only depends on its counter,
+ * any part of a stream can be generated independently of the others.
+ */
+inline std::array<uint32_t, 4>
+philox4x32(std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key)
+{
+    for (unsigned round = 0; round < 10; ++round)
+    {
+        uint64_t const product0 = static_cast<uint64_t>(0xD2511F53u) * counter[0];
+        uint64_t const product1 = static_cast<uint64_t>(0xCD9E8D57u) * counter[2];
+        counter = {{static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+                    static_cast<uint32_t>(product1),
+                    static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+                    static_cast<uint32_t>(product0)}};
+        key[0] += 0x9E3779B9u;
+        key[1] += 0xBB67AE85u;
+    }
+    return counter;
+}
+
+// ----------------------------------------------------------------------------
+// Class PhiloxEngine
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class PhiloxEngine
+ * @headerfile philox.hpp
+ * @brief Random bit generator drawing the blocks of one Philox4x32-10 stream.
+ *
+ * @signature class PhiloxEngine;
+ *
+ * The stream is selected by the seed, which is the key, and a 64 bit stream id, which forms the upper half of the
+ * counter. Engines of different streams are independent, such that items, e.g. sequences, generated from their own
+ * stream come out identical regardless of how they are distributed over threads.
+ * Satisfies the <tt>UniformRandomBitGenerator</tt> requirements. The simulation draws its values with the
+ * distributions below instead of the <tt>std</tt> ones, whose algorithms differ between standard libraries.
+ */
+class PhiloxEngine
+{
+public:
+
+    using result_type = uint32_t;
+
+    PhiloxEngine(uint32_t const seed, uint64_t const stream) :
+        mKey{{seed, 0x5EED5EEDu}},
+        mStream(stream)
+    {}
+
+    static constexpr result_type min()
+    {
+        return std::numeric_limits<result_type>::min();
+    }
+
+    static constexpr result_type max()
+    {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    inline result_type operator()()
+    {
+        if (mUsed == 4)
+        {
+            mBlock = block();
+            mUsed = 0;
+        }
+        return mBlock[mUsed++];
+    }
+
+    // Returns the next four words of the stream at once, bypassing the words buffered for operator().
+    inline std::array<uint32_t, 4> block()
+    {
+        std::array<uint32_t, 4> const counter{{static_cast<uint32_t>(mBlockIndex),
+                                                static_cast<uint32_t>(mBlockIndex >> 32),
+                                                static_cast<uint32_t>(mStream),
+                                                static_cast<uint32_t>(mStream >> 32)}};
+        ++mBlockIndex;
+        return philox4x32(counter, mKey);
+    }
+
+private:
+
+    std::array<uint32_t, 2> mKey;
+    uint64_t                mStream;
+    uint64_t                mBlockIndex{0};
+    std::array<uint32_t, 4> mBlock{{0, 0, 0, 0}};
+    unsigned                mUsed{4};
+};
+
+// ----------------------------------------------------------------------------
+// Function uniformReal()
+// ----------------------------------------------------------------------------
+
+/*!
+ * @fn uniformReal
+ * @headerfile philox.hpp
+ * @brief Draws a uniformly distributed value in [0, 1) from the upper 53 bits of two words.
+ *
+ * @signature double uniformReal(engine);
+ *
+ * This and the following distributions are implemented here, such that a seed yields the same values with every
+ * standard library. They only use the functions of <tt>cmath</tt>.
+ */
+template <typename TEngine>
+inline double
+uniformReal(TEngine & engine)
+{
+    uint64_t const high = engine() >> 5;
+    uint64_t const low = engine() >> 6;
+    return (high * 67108864.0 + low) * (1.0 / 9007199254740992.0);
+}
+
+// ----------------------------------------------------------------------------
+// Function uniformInt()
+// ----------------------------------------------------------------------------
+
+/*!
+ * @fn uniformInt
+ * @headerfile philox.hpp
+ * @brief Draws a uniformly distributed integer in [first, last].
+ *
+ * @signature uint64_t uniformInt(engine, first, last);
+ *
+ * Draws 64 bit values and rejects those below <tt>2^64 mod n</tt>, where n is the number of values in the interval,
+ * such that the remainders are unbiased.
+ */
+template <typename TEngine>
+inline uint64_t
+uniformInt(TEngine & engine, uint64_t const first, uint64_t const last)
+{
+    auto next = [&] ()
+    {
+        uint64_t const high = engine();
+        return (high << 32) | engine();
+    };
+
+    uint64_t const range = last - first + 1;
+    if (range == 0)  // The full range of uint64_t.
+        return next();
+
+    uint64_t const threshold = (0 - range) % range;
+    uint64_t value = next();
+    while (value < threshold)
+        value = next();
+    return first + value % range;
+}
+
+// ----------------------------------------------------------------------------
+// Function normalValue()
+// ----------------------------------------------------------------------------
+
+// Draws a normally distributed value with the Box-Muller transform, using one of the two values of a transform.
+template <typename TEngine>
+inline double
+normalValue(TEngine & engine, double const mean, double const sd)
+{
+    double const u1 = 1.0 - uniformReal(engine);  // In (0, 1] for the logarithm.
+    double const u2 = uniformReal(engine);
+    return mean + sd * std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+}
+
+// ----------------------------------------------------------------------------
+// Function gammaValue()
+// ----------------------------------------------------------------------------
+
+// Draws a gamma distributed value with the method of Marsaglia and Tsang (2000). Shapes below 1 are boosted by
+// x * u^(1 / shape), where x is drawn with shape + 1.
+template <typename TEngine>
+inline double
+gammaValue(TEngine & engine, double const shape, double const scale)
+{
+    if (shape < 1.0)
+    {
+        double const u = 1.0 - uniformReal(engine);
+        return gammaValue(engine, shape + 1.0, scale) * std::pow(u, 1.0 / shape);
+    }
+
+    double const d = shape - 1.0 / 3.0;
+    double const c = 1.0 / std::sqrt(9.0 * d);
+    while (true)
+    {
+        double const x = normalValue(engine, 0.0, 1.0);
+        double v = 1.0 + c * x;
+        if (v <= 0.0)
+            continue;
+        v = v * v * v;
+        double const u = 1.0 - uniformReal(engine);
+        if (std::log(u) < 0.5 * x * x + d - d * v + d * std::log(v))
+            return d * v * scale;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Function geometricValue()
+// ----------------------------------------------------------------------------
+
+// Draws the number of failures before the first success of trials with success probability p, by inversion.
+template <typename TEngine>
+inline uint64_t
+geometricValue(TEngine & engine, double const p)
+{
+    if (p >= 1.0)
+        return 0;
+    double const u = 1.0 - uniformReal(engine);
+    return static_cast<uint64_t>(std::floor(std::log(u) / std::log1p(-p)));
+}
+
+#endif  // PHILOX_HPP_
@@ -0,0 +1,234 @@
+// ==========================================================================
+//                 SeqAn - The Library for Sequence Analysis
+// ==========================================================================
+// Copyright (c) 2006-2018, Knut Reinert, FU Berlin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Knut Reinert or the FU Berlin nor the names of
+//       its contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Rene Rahn <rene.rahn@fu-berlin.de>
+// ==========================================================================
+
+#ifndef RAPL_ENERGY_HPP_
+#define RAPL_ENERGY_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <dirent.h>
+#endif  // defined(__linux__)
+
+// ----------------------------------------------------------------------------
+// Class EnergyStats
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class EnergyStats
+ * @headerfile rapl_energy.hpp
+ * @brief Mean energy consumption of the timed runs in joules.
+ *
+ * The values are summed over all sockets. Negative values denote domains that are not available.
+ */
+struct EnergyStats
+{
+    double  packageJoules{-1.0};
+    double  dramJoules{-1.0};
+
+    inline bool isAvailable() const
+    {
+        return packageJoules >= 0.0;
+    }
+
+    // Package and DRAM energy, if the latter is available.
+    inline double totalJoules() const
+    {
+        return std::max(packageJoules, 0.0) + std::max(dramJoules, 0.0);
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Class RaplDomain
+// ----------------------------------------------------------------------------
+
+// A powercap zone with its cumulative energy counter in micro joules.
+struct RaplDomain
+{
+    enum Kind : uint8_t
+    {
+        PACKAGE,
+        DRAM
+    };
+
+    Kind        kind;
+    std::string energyFile;
+    uint64_t    maxEnergyRange;
+};
+
+// ============================================================================
+// Functions
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Function readRaplValue()
+// ----------------------------------------------------------------------------
+
+// Returns false if the file cannot be read, e.g. because energy_uj is only readable by root.
+inline bool readRaplValue(std::string const & file, uint64_t & value)
+{
+    std::ifstream stream(file);
+    return static_cast<bool>(stream >> value);
+}
+
+// ----------------------------------------------------------------------------
+// Function raplDomains()
+// ----------------------------------------------------------------------------
+
+// Enumerates the readable package and DRAM zones below /sys/class/powercap once per process.
+inline std::vector<RaplDomain> const & raplDomains()
+{
+    static std::vector<RaplDomain> const domains = []
+    {
+        std::vector<RaplDomain> res;
+#if defined(__linux__)
+        std::string const root = "/sys/class/powercap/";
+        DIR * dir = opendir(root.c_str());
+        if (dir == nullptr)
+            return res;
+
+        while (dirent * entry = readdir(dir))
+        {
+            // Zones are named intel-rapl:<socket> and subzones intel-rapl:<socket>:<index>.
+            std::string const zone = entry->d_name;
+            if (zone.compare(0, 11, "intel-rapl:") != 0)
+                continue;
+
+            std::string name;
+            std::ifstream nameFile(root + zone + "/name");
+            if (!(nameFile >> name))
+                continue;
+
+            RaplDomain domain;
+            if (name.compare(0, 8, "package-") == 0)
+                domain.kind = RaplDomain::PACKAGE;
+            else if (name == "dram")
+                domain.kind = RaplDomain::DRAM;
+            else
+                continue;
+
+            uint64_t value = 0;
+            domain.energyFile = root + zone + "/energy_uj";
+            if (!readRaplValue(domain.energyFile, value) ||
+                !readRaplValue(root + zone + "/max_energy_range_uj", domain.maxEnergyRange))
+                continue;
+            res.push_back(domain);
+        }
+        closedir(dir);
+#endif  // defined(__linux__)
+        return res;
+    }();
+    return domains;
+}
+
+// ----------------------------------------------------------------------------
+// Class EnergyProbe
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class EnergyProbe
+ * @headerfile rapl_energy.hpp
+ * @brief Reads the RAPL energy counters at the begin and end of a measured region.
+ *
+ * The counters wrap around at <tt>max_energy_range_uj</tt>, which takes minutes even at full load, so a single
+ * wrap-around per run is accounted for. If no counters are readable, the stats are reported as unavailable.
+ */
+class EnergyProbe
+{
+public:
+
+    inline void start()
+    {
+        auto const & domains = raplDomains();
+        mBegin.resize(domains.size());
+        for (size_t i = 0; i < domains.size(); ++i)
+            readRaplValue(domains[i].energyFile, mBegin[i]);
+    }
+
+    inline void stop()
+    {
+        auto const & domains = raplDomains();
+        for (size_t i = 0; i < domains.size(); ++i)
+        {
+            uint64_t end = 0;
+            readRaplValue(domains[i].energyFile, end);
+            uint64_t const delta = (end >= mBegin[i]) ? end - mBegin[i]
+                                                      : end + domains[i].maxEnergyRange - mBegin[i];
+            if (domains[i].kind == RaplDomain::PACKAGE)
+                mPackage += delta;
+            else
+                mDram += delta;
+        }
+        ++mRuns;
+    }
+
+    inline void reset()
+    {
+        mPackage = 0;
+        mDram = 0;
+        mRuns = 0;
+    }
+
+    inline EnergyStats getStats() const
+    {
+        EnergyStats res;
+        if (mRuns == 0)
+            return res;
+
+        bool hasDram = false;
+        for (auto const & domain : raplDomains())
+        {
+            if (domain.kind == RaplDomain::PACKAGE)
+                res.packageJoules = static_cast<double>(mPackage) / mRuns / 1e6;
+            else
+                hasDram = true;
+        }
+        if (hasDram)
+            res.dramJoules = static_cast<double>(mDram) / mRuns / 1e6;
+        return res;
+    }
+
+private:
+
+    std::vector<uint64_t>   mBegin;
+    uint64_t                mPackage{0};
+    uint64_t                mDram{0};
+    unsigned                mRuns{0};
+};
+
+#endif  // RAPL_ENERGY_HPP_
@@ -0,0 +1,117 @@
+// ==========================================================================
+//                 SeqAn - The Library for Sequence Analysis
+// ==========================================================================
+// Copyright (c) 2006-2018, Knut Reinert, FU Berlin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Knut Reinert or the FU Berlin nor the names of
+//       its contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Rene Rahn <rene.rahn@fu-berlin.de>
+// ==========================================================================
+
+#ifndef RUN_STATISTICS_HPP_
+#define RUN_STATISTICS_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// Class RunStatistics
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class RunStatistics
+ * @headerfile run_statistics.hpp
+ * @brief Summary of the throughput measured over repeated timed runs.
+ *
+ * All values are given in GCUPS. <tt>p95</tt> is the throughput of the run at the 95th percentile of the
+ * run times, i.e. the slow tail that is exceeded by only 5% of the runs.
+ */
+struct RunStatistics
+{
+    double min{0.0};
+    double median{0.0};
+    double mean{0.0};
+    double stddev{0.0};
+    double p95{0.0};
+};
+
+// ============================================================================
+// Functions
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Function percentile()
+// ----------------------------------------------------------------------------
+
+// Nearest-rank percentile of an ascending sorted sample.
+inline double percentile(std::vector<double> const & sorted, double const p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+// ----------------------------------------------------------------------------
+// Function computeRunStatistics()
+// ----------------------------------------------------------------------------
+
+inline RunStatistics computeRunStatistics(std::vector<double> const & runTimes, double const totalCells)
+{
+    RunStatistics res;
+    if (runTimes.empty())
+        return res;
+
+    std::vector<double> gcups;
+    gcups.reserve(runTimes.size());
+    for (double t : runTimes)
+        gcups.push_back((t > 0.0) ? (totalCells / t) / 1000000000.0 : 0.0);
+    std::sort(gcups.begin(), gcups.end());
+
+    res.min = gcups.front();
+    size_t mid = gcups.size() / 2;
+    res.median = (gcups.size() % 2 == 0) ? (gcups[mid - 1] + gcups[mid]) / 2.0 : gcups[mid];
+
+    for (double g : gcups)
+        res.mean += g;
+    res.mean /= gcups.size();
+
+    if (gcups.size() > 1)
+    {
+        for (double g : gcups)
+            res.stddev += (g - res.mean) * (g - res.mean);
+        res.stddev = std::sqrt(res.stddev / (gcups.size() - 1));
+    }
+
+    // The slowest 5% of the runs correspond to the lowest 5% of the throughput values.
+    res.p95 = percentile(gcups, 5.0);
+    return res;
+}
+
+#endif  // #ifndef RUN_STATISTICS_HPP_
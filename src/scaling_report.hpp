@@ -0,0 +1,141 @@
+// ==========================================================================
+//                 SeqAn - The Library for Sequence Analysis
+// ==========================================================================
+// Copyright (c) 2006-2018, Knut Reinert, FU Berlin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Knut Reinert or the FU Berlin nor the names of
+//       its contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Rene Rahn <rene.rahn@fu-berlin.de>
+// ==========================================================================
+
+#ifndef SCALING_REPORT_HPP_
+#define SCALING_REPORT_HPP_
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// Class ScalingPoint
+// ----------------------------------------------------------------------------
+
+struct ScalingPoint
+{
+    unsigned    threads;
+    double      time;
+    double      totalCells;
+
+    inline double gcups() const
+    {
+        return (time > 0.0) ? (totalCells / time) / 1000000000.0 : 0.0;
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Class ScalingReport
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class ScalingReport
+ * @headerfile scaling_report.hpp
+ * @brief Speedup, parallel efficiency and Karp-Flatt serial fraction of a series of runs.
+ *
+ * The speedup is the ratio of the throughput to the throughput with one thread. For strong scaling this equals
+ * <tt>T(1)/T(p)</tt>, for weak scaling, where the work grows with <tt>p</tt>, it is the scaled speedup.
+ * The efficiency is the speedup divided by <tt>p</tt>. The Karp-Flatt metric
+ * <tt>e = (1/S - 1/p) / (1 - 1/p)</tt> estimates the serial fraction; if it grows with <tt>p</tt>, the loss of
+ * efficiency is caused by parallel overhead rather than by a serial part of the program.
+ */
+class ScalingReport
+{
+public:
+
+    ScalingReport(std::string mode, std::string policy) : mMode(std::move(mode)), mPolicy(std::move(policy))
+    {}
+
+    inline void add(ScalingPoint const & point)
+    {
+        mPoints.push_back(point);
+    }
+
+    template <typename TStream>
+    inline void write(TStream & stream) const
+    {
+        stream << "Scaling,Policy,#Threads,Time,GCUPS,Speedup,Efficiency,KarpFlatt\n";
+        if (mPoints.empty())
+            return;
+
+        auto base = std::find_if(mPoints.begin(), mPoints.end(), [](auto const & p) { return p.threads == 1; });
+        double baseGcups = (base != mPoints.end()) ? base->gcups() : 0.0;
+
+        for (auto const & point : mPoints)
+        {
+            stream << mMode << "," << mPolicy << "," << point.threads << "," << point.time << "," << point.gcups()
+                   << ",";
+            if (baseGcups <= 0.0)
+            {
+                stream << "n/a,n/a,n/a\n";
+                continue;
+            }
+
+            double p = point.threads;
+            double speedup = point.gcups() / baseGcups;
+            stream << speedup << "," << speedup / p << ",";
+            if (point.threads > 1 && speedup > 0.0)
+                stream << (1.0 / speedup - 1.0 / p) / (1.0 - 1.0 / p) << "\n";
+            else
+                stream << "n/a\n";
+        }
+    }
+
+private:
+
+    std::string                 mMode;
+    std::string                 mPolicy;
+    std::vector<ScalingPoint>   mPoints;
+};
+
+// ============================================================================
+// Functions
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Function scalingThreadCounts()
+// ----------------------------------------------------------------------------
+
+// Returns 1, 2, 4, ... up to and including maxThreads.
+inline std::vector<unsigned> scalingThreadCounts(unsigned const maxThreads)
+{
+    std::vector<unsigned> counts;
+    for (unsigned t = 1; t < maxThreads; t <<= 1)
+        counts.push_back(t);
+    counts.push_back(std::max(maxThreads, 1u));
+    return counts;
+}
+
+#endif  // #ifndef SCALING_REPORT_HPP_
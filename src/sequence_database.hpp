@@ -0,0 +1,576 @@
+// ==========================================================================
+//                 SeqAn - The Library for Sequence Analysis
+// ==========================================================================
+// Copyright (c) 2006-2018, Knut Reinert, FU Berlin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Knut Reinert or the FU Berlin nor the names of
+//       its contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Rene Rahn <rene.rahn@fu-berlin.de>
+// ==========================================================================
+
+#ifndef SEQUENCE_DATABASE_HPP_
+#define SEQUENCE_DATABASE_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // defined(__unix__) || defined(__APPLE__)
+
+#include <seqan/basic.h>
+#include <seqan/sequence.h>
+
+using namespace seqan;
+
+// ============================================================================
+// Tags, Classes, Enums
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Class SequenceDatabaseHeader
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class SequenceDatabaseHeader
+ * @headerfile sequence_database.hpp
+ * @brief Header of a binary sequence database (<tt>.abdb</tt>).
+ *
+ * A database consists of the header followed by these sections, each starting at a multiple of
+ * <tt>SECTION_ALIGNMENT</tt> bytes:
+ *
+ * <ul>
+ * <li>the residues of all records as one byte ordinal values, stored back to back,</li>
+ * <li>one <tt>{offset, length}</tt> pair of <tt>uint64_t</tt> per record into the residues,</li>
+ * <li>the record ids ordered by ascending sequence length, which is stable for equal lengths,</li>
+ * <li><tt>numRecords + 1</tt> <tt>uint64_t</tt> offsets into the names and the names themselves.</li>
+ * </ul>
+ *
+ * All integers are stored in the byte order of the writing machine, which is verified by <tt>byteOrder</tt>.
+ * <tt>alphabet</tt> holds the zero padded name of the residue alphabet, see @link SequenceDatabaseAlphabet @endlink,
+ * since alphabets of the same size, e.g. <tt>Dna5</tt> and <tt>Rna5</tt>, cannot be told apart by their size.
+ */
+struct SequenceDatabaseHeader
+{
+    static constexpr uint32_t VERSION = 2;
+    static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+    static constexpr uint64_t SECTION_ALIGNMENT = 4096;
+
+    char        magic[4]{'A', 'B', 'D', 'B'};
+    uint32_t    version{VERSION};
+    uint32_t    byteOrder{BYTE_ORDER_MARK};
+    uint32_t    alphabetSize{0};
+    char        alphabet[8]{};
+    uint64_t    numRecords{0};
+    uint64_t    residuesOffset{0};
+    uint64_t    residuesBytes{0};
+    uint64_t    recordsOffset{0};
+    uint64_t    permutationOffset{0};
+    uint64_t    nameIndexOffset{0};
+    uint64_t    namesOffset{0};
+    uint64_t    namesBytes{0};
+};
+
+// ----------------------------------------------------------------------------
+// Metafunction SequenceDatabaseAlphabet
+// ----------------------------------------------------------------------------
+
+/*!
+ * @mfn SequenceDatabaseAlphabet
+ * @headerfile sequence_database.hpp
+ * @brief Name of an alphabet in the header of a sequence database.
+ *
+ * @signature char const * SequenceDatabaseAlphabet<TAlphabet>::name();
+ *
+ * Only the specialized alphabets can be stored in a database.
+ */
+template <typename TAlphabet>
+struct SequenceDatabaseAlphabet;
+
+template <>
+struct SequenceDatabaseAlphabet<Dna>
+{
+    static char const * name() { return "dna"; }
+};
+
+template <>
+struct SequenceDatabaseAlphabet<Dna5>
+{
+    static char const * name() { return "dna5"; }
+};
+
+template <>
+struct SequenceDatabaseAlphabet<Rna>
+{
+    static char const * name() { return "rna"; }
+};
+
+template <>
+struct SequenceDatabaseAlphabet<Rna5>
+{
+    static char const * name() { return "rna5"; }
+};
+
+template <>
+struct SequenceDatabaseAlphabet<Iupac>
+{
+    static char const * name() { return "iupac"; }
+};
+
+template <>
+struct SequenceDatabaseAlphabet<AminoAcid>
+{
+    static char const * name() { return "aa"; }
+};
+
+// ----------------------------------------------------------------------------
+// Class SequenceDatabase
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class SequenceDatabase
+ * @headerfile sequence_database.hpp
+ * @brief Binary sequence database read through a read-only memory mapping.
+ *
+ * @signature template <typename TAlphabet>
+ *            class SequenceDatabase;
+ *
+ * The residues are stored in the in-memory representation of <tt>TAlphabet</tt>. Opening a database copies the
+ * residue section as a whole into @link SequenceDatabase#host @endlink and drops its pages from the mapping, while
+ * the record table, the length order and the names are read from the mapping. Hence, no residue is parsed or
+ * converted, the records are exposed as infixes of the host, and the length order is read from the file instead
+ * of being sorted. Databases are written with @link writeSequenceDatabase @endlink.
+ *
+ * The object can neither be copied nor moved, since the views refer to its host.
+ */
+template <typename TAlphabet>
+class SequenceDatabase
+{
+public:
+
+    using THost = String<TAlphabet>;
+    using TView = typename Infix<THost const>::Type;
+
+    static_assert(sizeof(TAlphabet) == 1, "The database stores one byte per residue.");
+
+    SequenceDatabase() = default;
+    SequenceDatabase(SequenceDatabase const &) = delete;
+    SequenceDatabase & operator=(SequenceDatabase const &) = delete;
+
+    ~SequenceDatabase()
+    {
+        close();
+    }
+
+    // Maps the database. Returns false if the file cannot be mapped, is no database or stores another alphabet.
+    inline bool
+    open(std::string const & fileName)
+    {
+        close();
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd == -1)
+            return false;
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SequenceDatabaseHeader))
+        {
+            ::close(fd);
+            return false;
+        }
+
+        mSize = info.st_size;
+        void * data = mmap(nullptr, mSize, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED)
+            return false;
+
+        mData = static_cast<char const *>(data);
+        if (!validate())
+        {
+            close();
+            return false;
+        }
+        // SeqAn's simple types store their ordinal value, so the residues are copied as they are.
+        uint64_t const offset = header().residuesOffset;
+        uint64_t const bytes = header().residuesBytes;
+        madvise(const_cast<char *>(mData) + offset, bytes, MADV_SEQUENTIAL);
+        resize(mHost, bytes, Exact());
+        if (bytes != 0)
+            std::memcpy(&mHost[0], mData + offset, bytes);
+        // The residues are not read from the mapping again. The section starts at a page boundary.
+        madvise(const_cast<char *>(mData) + offset, bytes, MADV_DONTNEED);
+        return true;
+#else  // defined(__unix__) || defined(__APPLE__)
+        (void)fileName;
+        return false;
+#endif  // defined(__unix__) || defined(__APPLE__)
+    }
+
+    inline void
+    close()
+    {
+        clear(mHost);
+        shrinkToFit(mHost);
+#if defined(__unix__) || defined(__APPLE__)
+        if (mData != nullptr)
+            munmap(const_cast<char *>(mData), mSize);
+#endif  // defined(__unix__) || defined(__APPLE__)
+        mData = nullptr;
+        mSize = 0;
+    }
+
+    inline bool
+    isOpen() const
+    {
+        return mData != nullptr;
+    }
+
+    inline size_t
+    size() const
+    {
+        return isOpen() ? header().numRecords : 0;
+    }
+
+    inline THost const &
+    host() const
+    {
+        return mHost;
+    }
+
+    // Returns the residues of the i-th record as view into the host.
+    inline TView
+    operator[](size_t const i) const
+    {
+        uint64_t const * record = section<uint64_t>(header().recordsOffset) + 2 * i;
+        return infix(mHost, record[0], record[0] + record[1]);
+    }
+
+    // Returns the id of the i-th shortest record.
+    inline size_t
+    sortedIndex(size_t const i) const
+    {
+        return section<uint64_t>(header().permutationOffset)[i];
+    }
+
+    // Returns the header of the i-th record.
+    inline std::string
+    name(size_t const i) const
+    {
+        uint64_t const * nameIndex = section<uint64_t>(header().nameIndexOffset);
+        char const * names = section<char>(header().namesOffset);
+        return std::string(names + nameIndex[i], names + nameIndex[i + 1]);
+    }
+
+private:
+
+    inline SequenceDatabaseHeader const &
+    header() const
+    {
+        return *reinterpret_cast<SequenceDatabaseHeader const *>(mData);
+    }
+
+    template <typename TValue>
+    inline TValue const *
+    section(uint64_t const offset) const
+    {
+        return reinterpret_cast<TValue const *>(mData + offset);
+    }
+
+    // Checks the header and that every section lies within the file.
+    inline bool
+    validate() const
+    {
+        SequenceDatabaseHeader const & h = header();
+        if (std::memcmp(h.magic, SequenceDatabaseHeader{}.magic, sizeof(h.magic)) != 0 ||
+            h.version != SequenceDatabaseHeader::VERSION ||
+            h.byteOrder != SequenceDatabaseHeader::BYTE_ORDER_MARK ||
+            h.alphabetSize != ValueSize<TAlphabet>::VALUE ||
+            std::strncmp(h.alphabet, SequenceDatabaseAlphabet<TAlphabet>::name(), sizeof(h.alphabet)) != 0)
+            return false;
+
+        auto fits = [&](uint64_t const offset, uint64_t const bytes)
+        {
+            return offset % sizeof(uint64_t) == 0 && offset <= mSize && bytes <= mSize - offset;
+        };
+        uint64_t const n = h.numRecords;
+        if (n > mSize / sizeof(uint64_t) ||
+            !fits(h.residuesOffset, h.residuesBytes) ||
+            !fits(h.recordsOffset, 2 * n * sizeof(uint64_t)) ||
+            !fits(h.permutationOffset, n * sizeof(uint64_t)) ||
+            !fits(h.nameIndexOffset, (n + 1) * sizeof(uint64_t)) ||
+            !fits(h.namesOffset, h.namesBytes))
+            return false;
+
+        uint64_t const * record = section<uint64_t>(h.recordsOffset);
+        uint64_t const * nameIndex = section<uint64_t>(h.nameIndexOffset);
+        for (uint64_t i = 0; i < n; ++i)
+        {
+            if (record[2 * i] > h.residuesBytes || record[2 * i + 1] > h.residuesBytes - record[2 * i] ||
+                section<uint64_t>(h.permutationOffset)[i] >= n || nameIndex[i] > nameIndex[i + 1])
+                return false;
+        }
+        return nameIndex[n] <= h.namesBytes;
+    }
+
+    char const *    mData{nullptr};
+    size_t          mSize{0};
+    THost           mHost;
+};
+
+// ============================================================================
+// Functions
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Function isSequenceDatabaseFile()
+// ----------------------------------------------------------------------------
+
+// Returns true if the file starts with the magic bytes of a sequence database.
+inline bool
+isSequenceDatabaseFile(std::string const & fileName)
+{
+    char magic[4] = {};
+    std::ifstream file(fileName, std::ios::binary);
+    file.read(magic, sizeof(magic));
+    return file.gcount() == sizeof(magic) &&
+           std::memcmp(magic, SequenceDatabaseHeader{}.magic, sizeof(magic)) == 0;
+}
+
+// ----------------------------------------------------------------------------
+// Function sequenceDatabaseAlphabet()
+// ----------------------------------------------------------------------------
+
+// Returns the name of the alphabet a database is stored in, see SequenceDatabaseAlphabet, or an empty string if the
+// file is no database of the current version.
+inline std::string
+sequenceDatabaseAlphabet(std::string const & fileName)
+{
+    SequenceDatabaseHeader header;
+    std::ifstream file(fileName, std::ios::binary);
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (file.gcount() != sizeof(header) ||
+        std::memcmp(header.magic, SequenceDatabaseHeader{}.magic, sizeof(header.magic)) != 0 ||
+        header.version != SequenceDatabaseHeader::VERSION ||
+        header.byteOrder != SequenceDatabaseHeader::BYTE_ORDER_MARK)
+        return "";
+    return std::string(header.alphabet, strnlen(header.alphabet, sizeof(header.alphabet)));
+}
+
+// ----------------------------------------------------------------------------
+// Function writeSequenceDatabase()
+// ----------------------------------------------------------------------------
+
+/*!
+ * @fn writeSequenceDatabase
+ * @headerfile sequence_database.hpp
+ * @brief Writes records to a binary sequence database.
+ *
+ * @signature bool writeSequenceDatabase(fileName, names, seqs)
+ *
+ * @param fileName  The file to write.
+ * @param names     The record names. A @link StringSet @endlink of <tt>CharString</tt>.
+ * @param seqs      The sequences. A @link StringSet @endlink of strings over a one byte alphabet.
+ *
+ * @return bool false if the file could not be written.
+ */
+template <typename TNames, typename TSeqs>
+inline bool
+writeSequenceDatabase(std::string const & fileName, TNames const & names, TSeqs const & seqs)
+{
+    using TAlphabet = typename Value<typename Value<TSeqs>::Type>::Type;
+    static_assert(sizeof(TAlphabet) == 1, "The database stores one byte per residue.");
+
+    uint64_t const n = length(seqs);
+    if (length(names) != n)
+        return false;
+
+    auto align = [](uint64_t const offset)
+    {
+        uint64_t const a = SequenceDatabaseHeader::SECTION_ALIGNMENT;
+        return (offset + a - 1) / a * a;
+    };
+
+    std::vector<uint64_t> records(2 * n);
+    std::vector<uint64_t> nameIndex(n + 1, 0);
+    SequenceDatabaseHeader header;
+    header.alphabetSize = ValueSize<TAlphabet>::VALUE;
+    std::strncpy(header.alphabet, SequenceDatabaseAlphabet<TAlphabet>::name(), sizeof(header.alphabet));
+    header.numRecords = n;
+    for (uint64_t i = 0; i < n; ++i)
+    {
+        records[2 * i] = header.residuesBytes;
+        records[2 * i + 1] = length(seqs[i]);
+        header.residuesBytes += length(seqs[i]);
+        nameIndex[i + 1] = nameIndex[i] + length(names[i]);
+    }
+    header.namesBytes = nameIndex[n];
+
+    std::vector<uint64_t> permutation(n);
+    std::iota(permutation.begin(), permutation.end(), 0);
+    std::stable_sort(permutation.begin(), permutation.end(), [&](uint64_t const i, uint64_t const j)
+    {
+        return records[2 * i + 1] < records[2 * j + 1];
+    });
+
+    header.residuesOffset = align(sizeof(header));
+    header.recordsOffset = align(header.residuesOffset + header.residuesBytes);
+    header.permutationOffset = align(header.recordsOffset + records.size() * sizeof(uint64_t));
+    header.nameIndexOffset = align(header.permutationOffset + permutation.size() * sizeof(uint64_t));
+    header.namesOffset = align(header.nameIndexOffset + nameIndex.size() * sizeof(uint64_t));
+
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    auto write = [&](char const * data, uint64_t const bytes)
+    {
+        file.write(data, bytes);
+    };
+    auto pad = [&](uint64_t const offset)
+    {
+        std::vector<char> zeros(offset - static_cast<uint64_t>(file.tellp()), 0);
+        write(zeros.data(), zeros.size());
+    };
+
+    write(reinterpret_cast<char const *>(&header), sizeof(header));
+    pad(header.residuesOffset);
+    for (uint64_t i = 0; i < n; ++i)
+    {
+        // SeqAn's simple types store their ordinal value, which is thus written as is.
+        if (!empty(seqs[i]))
+            write(reinterpret_cast<char const *>(&seqs[i][0]), length(seqs[i]));
+    }
+    pad(header.recordsOffset);
+    write(reinterpret_cast<char const *>(records.data()), records.size() * sizeof(uint64_t));
+    pad(header.permutationOffset);
+    write(reinterpret_cast<char const *>(permutation.data()), permutation.size() * sizeof(uint64_t));
+    pad(header.nameIndexOffset);
+    write(reinterpret_cast<char const *>(nameIndex.data()), nameIndex.size() * sizeof(uint64_t));
+    pad(header.namesOffset);
+    for (uint64_t i = 0; i < n; ++i)
+    {
+        if (!empty(names[i]))
+            write(&names[i][0], length(names[i]));
+    }
+    return static_cast<bool>(file);
+}
+
+// ----------------------------------------------------------------------------
+// Function readSequenceDatabase()
+// ----------------------------------------------------------------------------
+
+namespace impl
+{
+namespace sequence_database
+{
+
+template <typename TSequence, typename TRecord>
+inline void
+copyResidues(TSequence & seq, TRecord const & record, std::true_type const & /*sameAlphabet*/)
+{
+    assign(seq, record, Exact());
+}
+
+// Residues of another alphabet are converted through their character, e.g. N of Dna5 to A of Dna.
+template <typename TSequence, typename TRecord>
+inline void
+copyResidues(TSequence & seq, TRecord const & record, std::false_type const & /*sameAlphabet*/)
+{
+    using TAlphabet = typename Value<TSequence>::Type;
+    resize(seq, length(record), Exact());
+    for (size_t k = 0; k < length(record); ++k)
+        seq[k] = TAlphabet(static_cast<char>(record[k]));
+}
+
+// Copies the records of a database stored in TStored.
+template <typename TStored, typename TNames, typename TSeqs>
+inline bool
+copyRecords(TNames & names, TSeqs & seqs, std::string const & fileName)
+{
+    using TAlphabet = typename Value<typename Value<TSeqs>::Type>::Type;
+
+    SequenceDatabase<TStored> database;
+    if (!database.open(fileName))
+        return false;
+
+    clear(names);
+    clear(seqs);
+    resize(names, database.size(), Exact());
+    resize(seqs, database.size(), Exact());
+    for (size_t i = 0; i < database.size(); ++i)
+    {
+        assign(names[i], database.name(i));
+        copyResidues(seqs[i], database[i], std::is_same<TStored, TAlphabet>{});
+    }
+    return true;
+}
+
+}  // namespace sequence_database
+}  // namespace impl
+
+// Copies all records of a database into owning sets, e.g. for tools that do not work on views. Databases stored in
+// the alphabet of seqs are copied as they are, since the residues are stored in their in-memory representation.
+// Nucleotide databases are converted into any nucleotide alphabet, e.g. a Dna5 database into Dna.
+// Returns false if the database cannot be opened or stores residues of another kind.
+template <typename TNames, typename TSeqs>
+inline bool
+readSequenceDatabase(TNames & names, TSeqs & seqs, std::string const & fileName)
+{
+    using namespace impl::sequence_database;
+    using TAlphabet = typename Value<typename Value<TSeqs>::Type>::Type;
+
+    std::string const stored = sequenceDatabaseAlphabet(fileName);
+    std::string const target = SequenceDatabaseAlphabet<TAlphabet>::name();
+    if (stored == target)
+        return copyRecords<TAlphabet>(names, seqs, fileName);
+    if (stored == "aa" || target == "aa")
+        return false;
+
+    if (stored == "dna")
+        return copyRecords<Dna>(names, seqs, fileName);
+    if (stored == "dna5")
+        return copyRecords<Dna5>(names, seqs, fileName);
+    if (stored == "rna")
+        return copyRecords<Rna>(names, seqs, fileName);
+    if (stored == "rna5")
+        return copyRecords<Rna5>(names, seqs, fileName);
+    if (stored == "iupac")
+        return copyRecords<Iupac>(names, seqs, fileName);
+    return false;
+}
+
+#endif  // SEQUENCE_DATABASE_HPP_
@@ -35,17 +35,480 @@
 #ifndef SEQUENCE_GENERATOR_HPP_
 #define SEQUENCE_GENERATOR_HPP_
 
-#include <random>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <seqan/parallel.h>
+#include <seqan/score.h>
+
+#include "philox.hpp"
 
 namespace seqan
 {
 
-template <typename TAlphabet_ = Dna>
+// ----------------------------------------------------------------------------
+// Metafunction SimulatedValueSize
+// ----------------------------------------------------------------------------
+
+// Number of symbols simulated sequences are composed of. The wildcard N of Dna5 is not simulated.
+template <typename TAlphabet>
+struct SimulatedValueSize
+{
+    static constexpr unsigned VALUE = ValueSize<TAlphabet>::VALUE;
+};
+
+template <>
+struct SimulatedValueSize<Dna5>
+{
+    static constexpr unsigned VALUE = 4;
+};
+
+// ----------------------------------------------------------------------------
+// Function randomResidueBits()
+// ----------------------------------------------------------------------------
+
+// Random bits consumed per residue: exact for alphabets of a power of two size, otherwise 16 bits, which bounds
+// the bias of the multiply-shift mapping by alphabetSize / 2^16.
+constexpr unsigned randomResidueBits(unsigned const alphabetSize)
+{
+    unsigned bits = 1;
+    while ((1u << bits) < alphabetSize)
+        ++bits;
+    return ((alphabetSize & (alphabetSize - 1)) == 0) ? bits : 16;
+}
+
+// ----------------------------------------------------------------------------
+// Function fillRandomResidues()
+// ----------------------------------------------------------------------------
+
+// Fills str with uniformly distributed residues, extracting all residues of a 128 bit Philox block at once.
+template <typename TString>
+inline void
+fillRandomResidues(TString & str, PhiloxEngine & engine)
+{
+    using TAlphabet = typename Value<TString>::Type;
+    constexpr unsigned alphabetSize = SimulatedValueSize<TAlphabet>::VALUE;
+    constexpr unsigned bits = randomResidueBits(alphabetSize);
+    constexpr unsigned perWord = 32 / bits;
+    constexpr uint32_t mask = (1u << bits) - 1;
+
+    uint32_t residues[4 * perWord];
+    for (size_t i = 0; i < length(str); i += 4 * perWord)
+    {
+        std::array<uint32_t, 4> const block = engine.block();
+        for (unsigned w = 0; w < 4; ++w)
+            for (unsigned k = 0; k < perWord; ++k)
+                residues[w * perWord + k] = (((block[w] >> (k * bits)) & mask) * alphabetSize) >> bits;
+
+        size_t const count = std::min<size_t>(4 * perWord, length(str) - i);
+        // Assigned by position, since packed strings return proxies instead of references.
+        for (size_t k = 0; k < count; ++k)
+            str[i + k] = static_cast<TAlphabet>(residues[k]);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Class ResidueFrequencies
+// ----------------------------------------------------------------------------
+
+// Background frequencies of the simulated residues and the substitution scores weighting their substitutions.
+// Empty for uniformly distributed residues.
+template <typename TAlphabet>
+struct ResidueFrequencies
+{
+    static std::vector<std::pair<char, double>> get()
+    {
+        return {};
+    }
+
+    static int score(TAlphabet const, TAlphabet const)
+    {
+        return 0;
+    }
+};
+
+// The background frequencies of the BLOSUM62 matrix (Henikoff and Henikoff, 1992).
+template <>
+struct ResidueFrequencies<AminoAcid>
+{
+    static int score(AminoAcid const a, AminoAcid const b)
+    {
+        static Score<int, ScoreMatrix<AminoAcid, ScoreSpecBlosum62>> const blosum62;
+        return seqan::score(blosum62, a, b);
+    }
+
+    static std::vector<std::pair<char, double>> get()
+    {
+        return {{'A', 0.074}, {'R', 0.052}, {'N', 0.045}, {'D', 0.053}, {'C', 0.025},
+                {'Q', 0.034}, {'E', 0.054}, {'G', 0.074}, {'H', 0.026}, {'I', 0.068},
+                {'L', 0.099}, {'K', 0.058}, {'M', 0.025}, {'F', 0.047}, {'P', 0.039},
+                {'S', 0.057}, {'T', 0.051}, {'W', 0.013}, {'Y', 0.032}, {'V', 0.073}};
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Class ResidueSampler
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class ResidueSampler
+ * @headerfile sequence_generator.hpp
+ * @brief Draws the residues of simulated sequences and their substitutions.
+ *
+ * @signature template <typename TAlphabet>
+ *            class ResidueSampler;
+ *
+ * Without @link ResidueFrequencies @endlink the residues are uniformly distributed over the
+ * <tt>SimulatedValueSize</tt> symbols and a substitution picks one of the other symbols uniformly.
+ * Otherwise, the residues follow the background frequencies p, looked up from 16 random bits. A substitution of
+ * residue a by b != a is drawn proportional to the target frequency p_b exp(lambda s(a, b)) of the BLOSUM62 matrix
+ * with the ungapped lambda = 0.3176 of BLAST.
+ */
+template <typename TAlphabet>
+class ResidueSampler
+{
+public:
+
+    static constexpr double LAMBDA = 0.3176;
+
+    ResidueSampler()
+    {
+        auto const frequencies = ResidueFrequencies<TAlphabet>::get();
+        if (frequencies.empty())
+            return;
+
+        std::vector<unsigned> symbols;
+        std::vector<double> weights;
+        double sum = 0.0;
+        for (auto const & frequency : frequencies)
+        {
+            symbols.push_back(ordValue(TAlphabet(frequency.first)));
+            weights.push_back(frequency.second);
+            sum += frequency.second;
+        }
+
+        // Quantile table: entry k holds the residue whose cumulative frequency interval contains (k + 0.5) / 2^16.
+        mBackground.resize(1u << 16);
+        double cumulative = 0.0;
+        size_t symbol = 0;
+        for (size_t k = 0; k < mBackground.size(); ++k)
+        {
+            double const quantile = (k + 0.5) / mBackground.size();
+            while (symbol + 1 < symbols.size() && quantile > (cumulative + weights[symbol]) / sum)
+                cumulative += weights[symbol++];
+            mBackground[k] = symbols[symbol];
+        }
+        mSymbols = symbols;
+        mBackgroundCdf = cumulativeSum(weights);
+
+        mSubstitutionCdf.resize(ValueSize<TAlphabet>::VALUE, mBackgroundCdf);
+        for (size_t a = 0; a < symbols.size(); ++a)
+        {
+            std::vector<double> targets(symbols.size(), 0.0);
+            for (size_t b = 0; b < symbols.size(); ++b)
+                if (a != b)
+                    targets[b] = weights[b] * std::exp(LAMBDA * ResidueFrequencies<TAlphabet>::score(TAlphabet(symbols[a]),
+                                                                                                  TAlphabet(symbols[b])));
+            mSubstitutionCdf[symbols[a]] = cumulativeSum(targets);
+        }
+    }
+
+    // Fills str with random residues.
+    template <typename TString>
+    inline void fill(TString & str, PhiloxEngine & engine) const
+    {
+        if (mBackground.empty())
+        {
+            fillRandomResidues(str, engine);
+            return;
+        }
+
+        for (size_t i = 0; i < length(str); i += 8)
+        {
+            std::array<uint32_t, 4> const block = engine.block();
+            size_t const count = std::min<size_t>(8, length(str) - i);
+            for (size_t k = 0; k < count; ++k)
+                str[i + k] = static_cast<TAlphabet>(mBackground[(block[k / 2] >> (16 * (k % 2))) & 0xFFFF]);
+        }
+    }
+
+    // Returns a random residue.
+    template <typename TEngine>
+    inline TAlphabet draw(TEngine & engine) const
+    {
+        if (mBackground.empty())
+        {
+            unsigned const symbol = uniformInt(engine, 0, SimulatedValueSize<TAlphabet>::VALUE - 1);
+            return static_cast<TAlphabet>(symbol);
+        }
+        return static_cast<TAlphabet>(mSymbols[_sample(mBackgroundCdf, engine)]);
+    }
+
+    // Returns a residue other than value.
+    template <typename TEngine>
+    inline TAlphabet substitute(TAlphabet const value, TEngine & engine) const
+    {
+        unsigned const alphabetSize = SimulatedValueSize<TAlphabet>::VALUE;
+        if (mBackground.empty())
+        {
+            if (ordValue(value) >= alphabetSize)
+                return draw(engine);
+            unsigned const shift = uniformInt(engine, 1, alphabetSize - 1);
+            return static_cast<TAlphabet>((ordValue(value) + shift) % alphabetSize);
+        }
+        return static_cast<TAlphabet>(mSymbols[_sample(mSubstitutionCdf[ordValue(value)], engine)]);
+    }
+
+private:
+
+    static std::vector<double> cumulativeSum(std::vector<double> const & weights)
+    {
+        std::vector<double> cdf(weights.size());
+        std::partial_sum(weights.begin(), weights.end(), cdf.begin());
+        return cdf;
+    }
+
+    // Index of the interval of the cumulative weights containing a uniform random value.
+    template <typename TEngine>
+    static size_t _sample(std::vector<double> const & cdf, TEngine & engine)
+    {
+        double const weight = uniformReal(engine) * cdf.back();
+        return std::min<size_t>(std::upper_bound(cdf.begin(), cdf.end(), weight) - cdf.begin(), cdf.size() - 1);
+    }
+
+    std::vector<unsigned>               mBackground;
+    std::vector<unsigned>               mSymbols;
+    std::vector<double>                 mBackgroundCdf;
+    std::vector<std::vector<double>>    mSubstitutionCdf;
+};
+
+template <typename TAlphabet>
+constexpr double ResidueSampler<TAlphabet>::LAMBDA;
+
+// ----------------------------------------------------------------------------
+// Class LengthBin
+// ----------------------------------------------------------------------------
+
+// Lengths [begin, end] of an empirical length histogram drawn with the relative frequency weight.
+struct LengthBin
+{
+    uint64_t begin;
+    uint64_t end;
+    double   weight;
+};
+
+// ----------------------------------------------------------------------------
+// Function readLengthHistogram()
+// ----------------------------------------------------------------------------
+
+/*!
+ * @fn readLengthHistogram
+ * @brief Reads an empirical length distribution.
+ *
+ * @signature bool readLengthHistogram(bins, fileName);
+ *
+ * Every line holds either a single observed length, a length and its weight, or the first and last length of a bin
+ * and its weight. Empty lines and lines starting with <tt>#</tt> are skipped.
+ * Returns false if the file could not be read, a line is malformed or the weights do not sum up to a positive value.
+ */
+inline bool
+readLengthHistogram(std::vector<LengthBin> & bins, std::string const & fileName)
+{
+    std::ifstream in(fileName);
+    if (!in.good())
+        return false;
+
+    bins.clear();
+    double totalWeight = 0.0;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream values(line);
+        std::vector<double> fields;
+        double value;
+        while (values >> value)
+            fields.push_back(value);
+        if (!values.eof() || fields.empty() || fields.size() > 3 || fields[0] < 0.0)
+            return false;
+
+        LengthBin bin;
+        bin.begin = static_cast<uint64_t>(fields[0]);
+        bin.end = (fields.size() == 3) ? static_cast<uint64_t>(fields[1]) : bin.begin;
+        bin.weight = (fields.size() == 1) ? 1.0 : fields.back();
+        if (bin.end < bin.begin || bin.weight < 0.0)
+            return false;
+        totalWeight += bin.weight;
+        bins.push_back(bin);
+    }
+    return totalWeight > 0.0;
+}
+
+// ----------------------------------------------------------------------------
+// Class BoundedLength
+// ----------------------------------------------------------------------------
+
+// Draws lengths from a continuous distribution truncated to [minLength, maxLength]. Values outside are redrawn,
+// after 64 rejections the last value is clamped.
+template <typename TDistribution>
+struct BoundedLength
+{
+    TDistribution dist;
+    double        minLength;
+    double        maxLength;
+
+    template <typename TEngine>
+    inline size_t operator()(TEngine & engine)
+    {
+        double value = dist(engine);
+        for (unsigned i = 0; i < 64 && (value < minLength || value > maxLength); ++i)
+            value = dist(engine);
+        return static_cast<size_t>(std::llround(std::min(std::max(value, minLength), maxLength)));
+    }
+};
+
+template <typename TDistribution>
+inline BoundedLength<TDistribution>
+boundedLength(TDistribution const & dist, double const minLength, double const maxLength)
+{
+    return BoundedLength<TDistribution>{dist, minLength, maxLength};
+}
+
+// ----------------------------------------------------------------------------
+// Class UniformLength
+// ----------------------------------------------------------------------------
+
+// Lengths uniformly distributed in [minLength, maxLength].
+struct UniformLength
+{
+    uint64_t minLength;
+    uint64_t maxLength;
+
+    template <typename TEngine>
+    inline size_t operator()(TEngine & engine)
+    {
+        return uniformInt(engine, minLength, maxLength);
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Class NormalDistribution
+// ----------------------------------------------------------------------------
+
+// Normal distribution, see normalValue().
+struct NormalDistribution
+{
+    double mean;
+    double sd;
+
+    template <typename TEngine>
+    inline double operator()(TEngine & engine)
+    {
+        return normalValue(engine, mean, sd);
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Class LognormalDistribution
+// ----------------------------------------------------------------------------
+
+// Lognormal distribution, whose logarithm has the mean mu and the standard deviation sigma.
+struct LognormalDistribution
+{
+    double mu;
+    double sigma;
+
+    template <typename TEngine>
+    inline double operator()(TEngine & engine)
+    {
+        return std::exp(normalValue(engine, mu, sigma));
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Class GammaDistribution
+// ----------------------------------------------------------------------------
+
+// Gamma distribution with the given shape and scale, see gammaValue().
+struct GammaDistribution
+{
+    double shape;
+    double scale;
+
+    template <typename TEngine>
+    inline double operator()(TEngine & engine)
+    {
+        return gammaValue(engine, shape, scale);
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Class ParetoDistribution
+// ----------------------------------------------------------------------------
+
+// Pareto distribution with scale xm and tail index alpha, sampled by inversion.
+struct ParetoDistribution
+{
+    double xm;
+    double alpha;
+
+    template <typename TEngine>
+    inline double operator()(TEngine & engine)
+    {
+        return xm * std::pow(1.0 - uniformReal(engine), -1.0 / alpha);
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Class EmpiricalLength
+// ----------------------------------------------------------------------------
+
+// Draws a bin of an empirical histogram by its weight and a length uniformly within the bin. The bins are shared
+// by all copies, such that a copy per sequence is cheap.
+struct EmpiricalLength
+{
+    std::shared_ptr<std::vector<LengthBin> const> bins;
+    std::shared_ptr<std::vector<double> const>    cumulativeWeights;
+
+    explicit EmpiricalLength(std::vector<LengthBin> const & histogram) :
+        bins(std::make_shared<std::vector<LengthBin> const>(histogram))
+    {
+        std::vector<double> cumulative;
+        cumulative.reserve(histogram.size());
+        double sum = 0.0;
+        for (LengthBin const & bin : histogram)
+            cumulative.push_back(sum += bin.weight);
+        cumulativeWeights = std::make_shared<std::vector<double> const>(std::move(cumulative));
+    }
+
+    template <typename TEngine>
+    inline size_t operator()(TEngine & engine)
+    {
+        double const weight = uniformReal(engine) * cumulativeWeights->back();
+        size_t const index = std::min<size_t>(std::upper_bound(cumulativeWeights->begin(), cumulativeWeights->end(),
+                                                               weight) - cumulativeWeights->begin(),
+                                              bins->size() - 1);
+        LengthBin const & bin = (*bins)[index];
+        return uniformInt(engine, bin.begin, bin.end);
+    }
+};
+
+template <typename TAlphabet_ = Dna, typename TStringSpec_ = Alloc<> >
 class SequenceGenerator
 {
 public:
 
     using TAlphabet = TAlphabet_;
+    using TString = String<TAlphabet, TStringSpec_>;
 
     // ----------------------------------------------------------------------------
     // Constructor.
@@ -54,9 +517,7 @@ public:
     // Default c'tor. - Needed?
     SequenceGenerator() : mSeed(-1), mMinLength(100), mMaxLength(1000), mNum(1),
                           mDist(DistributionFunction::UNIFORM_DISTRIBUTION)
-    {
-        mRng.seed(mSeed);
-    }
+    {}
 
     // ----------------------------------------------------------------------------
     // Member functions.
@@ -84,7 +545,42 @@ public:
         mDist = dist;
     }
 
-    inline StringSet<String<TAlphabet> > generate();
+    // Restarts the random streams, such that the same seed reproduces the same sets.
+    inline void setSeed(unsigned const seed)
+    {
+        mSeed = seed;
+        mSets = 0;
+    }
+
+    // Number of threads generating the sequences of a set. The sets do not depend on it.
+    inline void setThreads(unsigned const threads)
+    {
+        mThreads = std::max(threads, 1u);
+    }
+
+    inline void setMutationModel(MutationModel const & model)
+    {
+        mMutation = model;
+    }
+
+    inline void setLengthModel(LengthModel const & model)
+    {
+        mLengths = model;
+    }
+
+    // Bins of the empirical length distribution.
+    inline void setLengthHistogram(std::vector<LengthBin> const & bins)
+    {
+        mHistogram = bins;
+    }
+
+    inline StringSet<TString> generate();
+
+    inline StringSet<TString> mutate(StringSet<TString> const & origins);
+
+    inline StringSet<TString> generateFamilies(unsigned const families);
+
+    inline StringSet<TString> sample(TString const & genome);
 
 private:
 
@@ -101,50 +597,199 @@ private:
     unsigned                mMaxLength;
     unsigned                mNum;
     DistributionFunction    mDist;
-    std::mt19937            mRng;
+    MutationModel           mMutation;
+    LengthModel             mLengths;
+    std::vector<LengthBin>  mHistogram;
+    ResidueSampler<TAlphabet> mResidues;
+    unsigned                mThreads{1};
+    uint32_t                mSets{0};  // Number of generated sets, selects the random streams of the next set.
 };
 
 // ----------------------------------------------------------------------------
 // Function generate()
 // ----------------------------------------------------------------------------
 
-template <typename TAlphabet>
+// Every sequence draws its length and residues from its own Philox stream, identified by the set and the sequence
+// number. Hence, the sequences can be generated in any order and on any number of threads with identical results.
+template <typename TAlphabet, typename TStringSpec>
 template <typename TPdf>
 inline auto
-SequenceGenerator<TAlphabet>::generateImpl(TPdf & pdf)
+SequenceGenerator<TAlphabet, TStringSpec>::generateImpl(TPdf & pdf)
 {
-    StringSet<String<TAlphabet> > set;
+    StringSet<TString> set;
     resize(set, mNum, Exact());
+    uint64_t const setStreams = static_cast<uint64_t>(mSets++) << 32;
 
-    std::uniform_int_distribution<> charDis(0, ValueSize<TAlphabet>::VALUE - 1);
-
-    for (auto& str : set)
+    SEQAN_OMP_PRAGMA(parallel for schedule(dynamic, 16) num_threads(mThreads))
+    for (int64_t s = 0; s < static_cast<int64_t>(mNum); ++s)
     {
-        resize(str, static_cast<size_t>(pdf(mRng)), Exact());
-        for (auto& val : str)
-            val = static_cast<TAlphabet>(charDis(this->mRng));
+        PhiloxEngine engine(mSeed, setStreams | static_cast<uint64_t>(s));
+        TPdf lengthDis = pdf;
+        resize(set[s], static_cast<size_t>(lengthDis(engine)), Exact());
+        mResidues.fill(set[s], engine);
     }
     return set;
 }
 
-template <typename TAlphabet>
-inline StringSet<String<TAlphabet> >
-SequenceGenerator<TAlphabet>::generate()
+template <typename TAlphabet, typename TStringSpec>
+inline StringSet<typename SequenceGenerator<TAlphabet, TStringSpec>::TString>
+SequenceGenerator<TAlphabet, TStringSpec>::generate()
 {
     // Sanity check.
     if (this->mMaxLength < this->mMinLength)
         this->mMaxLength = this->mMinLength;
 
-    if (mDist == DistributionFunction::UNIFORM_DISTRIBUTION)
+    double const minLength = mMinLength;
+    double const maxLength = mMaxLength;
+    double const mean = (mLengths.mean > 0.0) ? mLengths.mean : (minLength + maxLength) / 2.0;
+    double const sd = (mLengths.sd >= 0.0) ? mLengths.sd : (maxLength - minLength) / 6.0;
+
+    switch (mDist)
+    {
+        case DistributionFunction::UNIFORM_DISTRIBUTION:
+            break;
+        case DistributionFunction::EMPIRICAL_DISTRIBUTION:
+        {
+            if (mHistogram.empty())
+                break;
+            EmpiricalLength lenDis(mHistogram);
+            return generateImpl(lenDis);
+        }
+        case DistributionFunction::PARETO_DISTRIBUTION:
+        {
+            double const xm = std::max(minLength, 1.0);
+            double const alpha = (mLengths.shape > 0.0) ? mLengths.shape : (mean > xm) ? mean / (mean - xm) : 2.0;
+            auto lenDis = boundedLength(ParetoDistribution{xm, alpha}, minLength, maxLength);
+            return generateImpl(lenDis);
+        }
+        default:
+        {
+            // Without spread every sequence has the mean length.
+            if (sd <= 0.0)
+            {
+                uint64_t const meanLength = std::llround(mean);
+                UniformLength lenDis{meanLength, meanLength};
+                return generateImpl(lenDis);
+            }
+
+            if (mDist == DistributionFunction::LOGNORMAL_DISTRIBUTION)
+            {
+                double const sigma2 = std::log1p((sd * sd) / (mean * mean));
+                auto lenDis = boundedLength(LognormalDistribution{std::log(mean) - sigma2 / 2.0, std::sqrt(sigma2)},
+                                            minLength, maxLength);
+                return generateImpl(lenDis);
+            }
+            if (mDist == DistributionFunction::GAMMA_DISTRIBUTION)
+            {
+                auto lenDis = boundedLength(GammaDistribution{(mean * mean) / (sd * sd), (sd * sd) / mean},
+                                            minLength, maxLength);
+                return generateImpl(lenDis);
+            }
+            auto lenDis = boundedLength(NormalDistribution{mean, sd}, minLength, maxLength);
+            return generateImpl(lenDis);
+        }
+    }
+
+    UniformLength lenDis{this->mMinLength, this->mMaxLength};
+    return generateImpl(lenDis);
+}
+
+// ----------------------------------------------------------------------------
+// Function mutate()
+// ----------------------------------------------------------------------------
+
+// Derives one sequence from every origin by walking the origin and applying the events of the mutation model:
+// before every residue an insertion of random residues, then either a deletion starting at the residue, a
+// substitution drawn by the ResidueSampler or a copy.
+template <typename TAlphabet, typename TStringSpec>
+inline StringSet<typename SequenceGenerator<TAlphabet, TStringSpec>::TString>
+SequenceGenerator<TAlphabet, TStringSpec>::mutate(StringSet<TString> const & origins)
+{
+    StringSet<TString> set;
+    resize(set, length(origins), Exact());
+    uint64_t const setStreams = static_cast<uint64_t>(mSets++) << 32;
+
+    double const extensionProbability = 1.0 / std::max(mMutation.meanIndelLength, 1.0);
+
+    SEQAN_OMP_PRAGMA(parallel for schedule(dynamic, 16) num_threads(mThreads))
+    for (int64_t s = 0; s < static_cast<int64_t>(length(origins)); ++s)
     {
-        std::uniform_int_distribution<> lenDis(this->mMinLength, this->mMaxLength);
-        return generateImpl(lenDis);
+        PhiloxEngine engine(mSeed, setStreams | static_cast<uint64_t>(s));
+        // The number of extensions of an indel is geometric, such that the lengths have the configured mean.
+
+        auto const & origin = origins[s];
+        auto & target = set[s];
+        reserve(target, length(origin) + length(origin) / 8);
+
+        for (size_t i = 0; i < length(origin);)
+        {
+            if (uniformReal(engine) < mMutation.insertionRate)
+            {
+                for (size_t k = 1 + geometricValue(engine, extensionProbability); k > 0; --k)
+                    appendValue(target, mResidues.draw(engine));
+            }
+
+            double const event = uniformReal(engine);
+            if (event < mMutation.deletionRate)
+            {
+                i += 1 + geometricValue(engine, extensionProbability);
+                continue;
+            }
+
+            TAlphabet value = origin[i];
+            if (event < mMutation.deletionRate + mMutation.substitutionRate)
+                value = mResidues.substitute(value, engine);
+            appendValue(target, value);
+            ++i;
+        }
     }
-    else
+    return set;
+}
+
+// ----------------------------------------------------------------------------
+// Function generateFamilies()
+// ----------------------------------------------------------------------------
+
+// Generates the given number of family roots and returns the configured number of members, where member i is a
+// copy of root i % families. The members are meant to be mutated, see mutate().
+template <typename TAlphabet, typename TStringSpec>
+inline StringSet<typename SequenceGenerator<TAlphabet, TStringSpec>::TString>
+SequenceGenerator<TAlphabet, TStringSpec>::generateFamilies(unsigned const families)
+{
+    unsigned const number = mNum;
+    mNum = std::max(families, 1u);
+    StringSet<TString> const roots = generate();
+    mNum = number;
+
+    StringSet<TString> members;
+    resize(members, mNum, Exact());
+    for (size_t i = 0; i < mNum; ++i)
+        members[i] = roots[i % length(roots)];
+    return members;
+}
+
+// ----------------------------------------------------------------------------
+// Function sample()
+// ----------------------------------------------------------------------------
+
+// Samples the configured number of reads from the genome. The read lengths follow the length model, limited to the
+// length of the genome, and the start positions are uniformly distributed, such that the reads overlap.
+template <typename TAlphabet, typename TStringSpec>
+inline StringSet<typename SequenceGenerator<TAlphabet, TStringSpec>::TString>
+SequenceGenerator<TAlphabet, TStringSpec>::sample(TString const & genome)
+{
+    StringSet<TString> set = generate();
+    uint64_t const setStreams = static_cast<uint64_t>(mSets++) << 32;
+
+    SEQAN_OMP_PRAGMA(parallel for schedule(dynamic, 16) num_threads(mThreads))
+    for (int64_t s = 0; s < static_cast<int64_t>(length(set)); ++s)
     {
-        std::normal_distribution<> lenDis((mMinLength + mMaxLength)/2, 1.0);
-        return generateImpl(lenDis);
+        PhiloxEngine engine(mSeed, setStreams | static_cast<uint64_t>(s));
+        size_t const readLength = std::min<size_t>(length(set[s]), length(genome));
+        size_t const begin = uniformInt(engine, 0, length(genome) - readLength);
+        set[s] = infix(genome, begin, begin + readLength);
     }
+    return set;
 }
 
 }
@@ -0,0 +1,465 @@
+// ==========================================================================
+//                 SeqAn - The Library for Sequence Analysis
+// ==========================================================================
+// Copyright (c) 2006-2018, Knut Reinert, FU Berlin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Knut Reinert or the FU Berlin nor the names of
+//       its contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Rene Rahn <rene.rahn@fu-berlin.de>
+// ==========================================================================
+
+#ifndef SIMD_LAYOUT_HPP_
+#define SIMD_LAYOUT_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // defined(__unix__) || defined(__APPLE__)
+
+#include <seqan/basic.h>
+#include <seqan/sequence.h>
+
+using namespace seqan;
+
+// ============================================================================
+// Tags, Classes, Enums
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Enum LengthBinning
+// ----------------------------------------------------------------------------
+
+// Assignment of the sequences to the lanes of the SIMD blocks.
+enum class LengthBinning : uint32_t
+{
+    INPUT,   // Consecutive sequences in input order.
+    SORTED   // Consecutive sequences in ascending length order, such that lanes of a block have similar lengths.
+};
+
+// ----------------------------------------------------------------------------
+// Class SimdLayoutHeader
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class SimdLayoutHeader
+ * @headerfile simd_layout.hpp
+ * @brief Header of a lane-interleaved sequence layout (<tt>.absl</tt>).
+ *
+ * The sequences are grouped into blocks of <tt>lanes</tt> sequences. A block is stored as one SIMD vector per
+ * position, holding the ordinal value of every lane's residue at that position, and spans as many vectors as its
+ * longest sequence. Shorter sequences and the unused lanes of the last block are padded with <tt>padValue</tt>.
+ *
+ * The header is followed by these sections, each starting at a multiple of <tt>SECTION_ALIGNMENT</tt> bytes:
+ *
+ * <ul>
+ * <li>one <tt>{first vector, number of vectors}</tt> pair of <tt>uint64_t</tt> per block,</li>
+ * <li>the record id of every lane of every block, or <tt>NO_SEQUENCE</tt> for unused lanes,</li>
+ * <li>the vectors of all blocks, stored back to back.</li>
+ * </ul>
+ */
+struct SimdLayoutHeader
+{
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+    static constexpr uint64_t SECTION_ALIGNMENT = 4096;
+    static constexpr uint64_t NO_SEQUENCE = std::numeric_limits<uint64_t>::max();
+
+    char            magic[4]{'A', 'B', 'S', 'L'};
+    uint32_t        version{VERSION};
+    uint32_t        byteOrder{BYTE_ORDER_MARK};
+    uint32_t        vectorBytes{0};
+    uint32_t        elementBytes{0};
+    uint32_t        lanes{0};
+    LengthBinning   binning{LengthBinning::INPUT};
+    int32_t         padValue{0};
+    uint64_t        numSequences{0};
+    uint64_t        numBlocks{0};
+    uint64_t        numVectors{0};
+    uint64_t        blocksOffset{0};
+    uint64_t        laneIdsOffset{0};
+    uint64_t        vectorsOffset{0};
+};
+
+// ----------------------------------------------------------------------------
+// Class SimdBlock
+// ----------------------------------------------------------------------------
+
+// View of the consecutive vectors of one block, which are not owned by the view.
+template <typename TSimdVector>
+struct SimdBlock
+{
+    TSimdVector const * data{nullptr};
+    size_t              size{0};
+
+    inline TSimdVector const &
+    operator[](size_t const i) const
+    {
+        return data[i];
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Class SimdLayout
+// ----------------------------------------------------------------------------
+
+/*!
+ * @class SimdLayout
+ * @headerfile simd_layout.hpp
+ * @brief Lane-interleaved sequence blocks mapped into memory.
+ *
+ * @signature template <typename TSimdVector>
+ *            class SimdLayout;
+ *
+ * Exposes every block as @link SimdBlock @endlink pointing into the mapping, hence the inter-sequence kernel of
+ * <tt>simd_test</tt> uses the blocks without transposing the sequences at query time.
+ * The vectors are aligned to their size within the mapping. Layouts are written with
+ * @link writeSimdLayout @endlink for one vector width and must match <tt>TSimdVector</tt> when opened.
+ *
+ * The object can neither be copied nor moved, since the views refer to its mapping.
+ */
+template <typename TSimdVector>
+class SimdLayout
+{
+public:
+
+    using TView = SimdBlock<TSimdVector>;
+
+    SimdLayout() = default;
+    SimdLayout(SimdLayout const &) = delete;
+    SimdLayout & operator=(SimdLayout const &) = delete;
+
+    ~SimdLayout()
+    {
+        close();
+    }
+
+    // Maps the layout. Returns false if the file cannot be mapped, is no layout or was written for another vector.
+    inline bool
+    open(std::string const & fileName)
+    {
+        close();
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd == -1)
+            return false;
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SimdLayoutHeader))
+        {
+            ::close(fd);
+            return false;
+        }
+
+        mSize = info.st_size;
+        void * data = mmap(nullptr, mSize, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED)
+            return false;
+
+        mData = static_cast<char const *>(data);
+        if (!validate())
+        {
+            close();
+            return false;
+        }
+        madvise(const_cast<char *>(mData), mSize, MADV_WILLNEED);
+        return true;
+#else  // defined(__unix__) || defined(__APPLE__)
+        (void)fileName;
+        return false;
+#endif  // defined(__unix__) || defined(__APPLE__)
+    }
+
+    inline void
+    close()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        if (mData != nullptr)
+            munmap(const_cast<char *>(mData), mSize);
+#endif  // defined(__unix__) || defined(__APPLE__)
+        mData = nullptr;
+        mSize = 0;
+    }
+
+    inline bool
+    isOpen() const
+    {
+        return mData != nullptr;
+    }
+
+    inline LengthBinning
+    binning() const
+    {
+        return header().binning;
+    }
+
+    inline size_t
+    numSequences() const
+    {
+        return isOpen() ? header().numSequences : 0;
+    }
+
+    inline size_t
+    numBlocks() const
+    {
+        return isOpen() ? header().numBlocks : 0;
+    }
+
+    // Returns the vectors of the b-th block as view into the mapping.
+    inline TView
+    operator[](size_t const b) const
+    {
+        uint64_t const * block = section<uint64_t>(header().blocksOffset) + 2 * b;
+        return TView{section<TSimdVector>(header().vectorsOffset) + block[0], static_cast<size_t>(block[1])};
+    }
+
+    // Returns the record id stored in the given lane of the b-th block or SimdLayoutHeader::NO_SEQUENCE.
+    inline uint64_t
+    sequenceId(size_t const b, size_t const lane) const
+    {
+        return section<uint64_t>(header().laneIdsOffset)[b * header().lanes + lane];
+    }
+
+private:
+
+    inline SimdLayoutHeader const &
+    header() const
+    {
+        return *reinterpret_cast<SimdLayoutHeader const *>(mData);
+    }
+
+    template <typename TValue>
+    inline TValue const *
+    section(uint64_t const offset) const
+    {
+        return reinterpret_cast<TValue const *>(mData + offset);
+    }
+
+    // Checks the header against the vector type, that every section lies within the file and that every lane holds
+    // a record id below numSequences or NO_SEQUENCE, such that the ids can index the records.
+    inline bool
+    validate() const
+    {
+        SimdLayoutHeader const & h = header();
+        if (std::memcmp(h.magic, SimdLayoutHeader{}.magic, sizeof(h.magic)) != 0 ||
+            h.version != SimdLayoutHeader::VERSION ||
+            h.byteOrder != SimdLayoutHeader::BYTE_ORDER_MARK ||
+            h.vectorBytes != sizeof(TSimdVector) ||
+            h.lanes != LENGTH<TSimdVector>::VALUE ||
+            h.elementBytes * h.lanes != h.vectorBytes)
+            return false;
+
+        auto fits = [&](uint64_t const offset, uint64_t const count, uint64_t const bytes)
+        {
+            return offset % bytes == 0 && offset <= mSize && count <= (mSize - offset) / bytes;
+        };
+        if (h.numBlocks > mSize / sizeof(uint64_t) ||
+            !fits(h.blocksOffset, 2 * h.numBlocks, sizeof(uint64_t)) ||
+            !fits(h.laneIdsOffset, h.numBlocks * h.lanes, sizeof(uint64_t)) ||
+            !fits(h.vectorsOffset, h.numVectors, h.vectorBytes))
+            return false;
+
+        uint64_t const * block = section<uint64_t>(h.blocksOffset);
+        for (uint64_t b = 0; b < h.numBlocks; ++b)
+        {
+            if (block[2 * b] > h.numVectors || block[2 * b + 1] > h.numVectors - block[2 * b])
+                return false;
+        }
+
+        uint64_t const * laneIds = section<uint64_t>(h.laneIdsOffset);
+        for (uint64_t i = 0; i < h.numBlocks * h.lanes; ++i)
+        {
+            if (laneIds[i] >= h.numSequences && laneIds[i] != SimdLayoutHeader::NO_SEQUENCE)
+                return false;
+        }
+        return true;
+    }
+
+    char const *    mData{nullptr};
+    size_t          mSize{0};
+};
+
+// ============================================================================
+// Functions
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// Function length()
+// ----------------------------------------------------------------------------
+
+template <typename TSimdVector>
+inline size_t
+length(SimdBlock<TSimdVector> const & block)
+{
+    return block.size;
+}
+
+// ----------------------------------------------------------------------------
+// Function isSimdLayoutFile()
+// ----------------------------------------------------------------------------
+
+// Returns true if the file starts with the magic bytes of a lane-interleaved layout.
+inline bool
+isSimdLayoutFile(std::string const & fileName)
+{
+    char magic[4] = {};
+    std::ifstream file(fileName, std::ios::binary);
+    file.read(magic, sizeof(magic));
+    return file.gcount() == sizeof(magic) &&
+           std::memcmp(magic, SimdLayoutHeader{}.magic, sizeof(magic)) == 0;
+}
+
+// ----------------------------------------------------------------------------
+// Function writeSimdLayout()
+// ----------------------------------------------------------------------------
+
+/*!
+ * @fn writeSimdLayout
+ * @headerfile simd_layout.hpp
+ * @brief Interleaves sequences into SIMD blocks and writes them to a layout file.
+ *
+ * @signature bool writeSimdLayout<TValue>(fileName, seqs, vectorBits, binning)
+ *
+ * @tparam TValue   The lane type of the vectors, e.g. <tt>int16_t</tt> for the 16 bit kernels.
+ * @param fileName  The file to write.
+ * @param seqs      The sequences. A @link StringSet @endlink.
+ * @param vectorBits The width of the vectors in bits, i.e. 128 for SSE4, 256 for AVX2 and 512 for AVX512.
+ * @param binning   The @link LengthBinning @endlink assigning sequences to lanes.
+ *
+ * Positions behind the end of a lane's sequence hold the alphabet size, which is no ordinal value of a residue.
+ *
+ * @return bool false if the file could not be written.
+ */
+template <typename TValue, typename TSeqs>
+inline bool
+writeSimdLayout(std::string const & fileName,
+                TSeqs const & seqs,
+                unsigned const vectorBits,
+                LengthBinning const binning)
+{
+    using TAlphabet = typename Value<typename Value<TSeqs>::Type>::Type;
+
+    if (vectorBits % (8 * sizeof(TValue)) != 0 || vectorBits < 8 * sizeof(TValue))
+        return false;
+
+    auto align = [](uint64_t const offset)
+    {
+        uint64_t const a = SimdLayoutHeader::SECTION_ALIGNMENT;
+        return (offset + a - 1) / a * a;
+    };
+
+    SimdLayoutHeader header;
+    header.vectorBytes = vectorBits / 8;
+    header.elementBytes = sizeof(TValue);
+    header.lanes = header.vectorBytes / header.elementBytes;
+    header.binning = binning;
+    header.padValue = ValueSize<TAlphabet>::VALUE;
+    header.numSequences = length(seqs);
+    header.numBlocks = (header.numSequences + header.lanes - 1) / header.lanes;
+
+    std::vector<uint64_t> order(header.numSequences);
+    std::iota(order.begin(), order.end(), 0);
+    if (binning == LengthBinning::SORTED)
+        std::stable_sort(order.begin(), order.end(), [&](uint64_t const i, uint64_t const j)
+        {
+            return length(seqs[i]) < length(seqs[j]);
+        });
+
+    uint64_t const noSequence = SimdLayoutHeader::NO_SEQUENCE;
+    std::vector<uint64_t> laneIds(header.numBlocks * header.lanes, noSequence);
+    std::copy(order.begin(), order.end(), laneIds.begin());
+
+    std::vector<uint64_t> blocks(2 * header.numBlocks);
+    for (uint64_t b = 0; b < header.numBlocks; ++b)
+    {
+        uint64_t blockLength = 0;
+        for (uint64_t lane = 0; lane < header.lanes; ++lane)
+        {
+            uint64_t const id = laneIds[b * header.lanes + lane];
+            if (id != noSequence)
+                blockLength = std::max<uint64_t>(blockLength, length(seqs[id]));
+        }
+        blocks[2 * b] = header.numVectors;
+        blocks[2 * b + 1] = blockLength;
+        header.numVectors += blockLength;
+    }
+
+    header.blocksOffset = align(sizeof(header));
+    header.laneIdsOffset = align(header.blocksOffset + blocks.size() * sizeof(uint64_t));
+    header.vectorsOffset = align(header.laneIdsOffset + laneIds.size() * sizeof(uint64_t));
+
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    auto write = [&](char const * data, uint64_t const bytes)
+    {
+        file.write(data, bytes);
+    };
+    auto pad = [&](uint64_t const offset)
+    {
+        std::vector<char> zeros(offset - static_cast<uint64_t>(file.tellp()), 0);
+        write(zeros.data(), zeros.size());
+    };
+
+    write(reinterpret_cast<char const *>(&header), sizeof(header));
+    pad(header.blocksOffset);
+    write(reinterpret_cast<char const *>(blocks.data()), blocks.size() * sizeof(uint64_t));
+    pad(header.laneIdsOffset);
+    write(reinterpret_cast<char const *>(laneIds.data()), laneIds.size() * sizeof(uint64_t));
+    pad(header.vectorsOffset);
+
+    // Transposes one block at a time, lane l of vector x holds position x of the sequence in lane l.
+    std::vector<TValue> buffer;
+    for (uint64_t b = 0; b < header.numBlocks; ++b)
+    {
+        buffer.assign(blocks[2 * b + 1] * header.lanes, static_cast<TValue>(header.padValue));
+        for (uint64_t lane = 0; lane < header.lanes; ++lane)
+        {
+            uint64_t const id = laneIds[b * header.lanes + lane];
+            if (id == noSequence)
+                continue;
+            for (uint64_t x = 0; x < length(seqs[id]); ++x)
+                buffer[x * header.lanes + lane] = static_cast<TValue>(ordValue(seqs[id][x]));
+        }
+        write(reinterpret_cast<char const *>(buffer.data()), buffer.size() * sizeof(TValue));
+    }
+    return static_cast<bool>(file);
+}
+
+#endif  // SIMD_LAYOUT_HPP_
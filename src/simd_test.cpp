@@ -3,6 +3,7 @@
 #include <fstream>
 
 
+#include <seqan/align.h>
 #include <seqan/arg_parse.h>
 #include <seqan/seq_io.h>
 #include <seqan/stream.h>
@@ -11,11 +12,13 @@
 
 #include "align_bench_options.hpp"
 #include "align_bench_parser.hpp"
+#include "parallel_reader.hpp"
+#include "simd_layout.hpp"
 
 inline ArgumentParser::ParseResult
 parseCommandLine(AlignBenchOptions & options, int const argc, char* argv[])
 {
-    ArgumentParser parser("align_bench_par");
+    ArgumentParser parser("simd_test");
 
     setShortDescription(parser, "Alignment Benchmark Tool");
     setVersion(parser, SEQAN_APP_VERSION " [" SEQAN_REVISION "]");
@@ -69,6 +72,42 @@ void _transform(TBuffer & buffer, TSequences const & sequences)
     }
 }
 
+// ----------------------------------------------------------------------------
+// Function readBlocks()
+// ----------------------------------------------------------------------------
+
+// Maps the file if it is a lane-interleaved layout, otherwise reads its sequences for _transform().
+template <typename TSimdVector, typename TSequences>
+bool readBlocks(SimdLayout<TSimdVector> & layout,
+                TSequences & sequences,
+                std::string const & fileName,
+                unsigned const threads)
+{
+    if (isSimdLayoutFile(fileName))
+    {
+        if (!layout.open(fileName))
+        {
+            std::cerr << "\n" << fileName << " is no layout for vectors of " << sizeof(TSimdVector) * 8 << " bits.";
+            return false;
+        }
+        return true;
+    }
+    StringSet<CharString> meta;
+    return readSequences(meta, sequences, fileName, threads);
+}
+
+// Returns the record aligned in the given lane of block b, which for transposed sequences is given by the input order.
+template <typename TSimdVector>
+uint64_t laneSequenceId(SimdLayout<TSimdVector> const & layout, size_t const numSequences, size_t const b, size_t const lane)
+{
+    if (layout.isOpen())
+        return layout.sequenceId(b, lane);
+    size_t const id = b * LENGTH<TSimdVector>::VALUE + lane;
+    if (id < numSequences)
+        return id;
+    return SimdLayoutHeader::NO_SEQUENCE;
+}
+
 int main(int argc, char* argv[])
 {
     AlignBenchOptions options;
@@ -77,33 +116,23 @@ int main(int argc, char* argv[])
         return EXIT_FAILURE;
 
     using TSimdVector = typename SimdVector<int16_t>::Type;
+    using TBlock = typename SimdLayout<TSimdVector>::TView;
 
     /*
-     * Read the sequences.
+     * Read the sequences or map their precomputed layouts, see abdb_convert --simd-width.
      */
 
     std::cout << "Reading sequences ..." << std::flush;
-    StringSet<CharString> meta1;
     StringSet<Dna5String> set1;
-    StringSet<CharString> meta2;
     StringSet<Dna5String> set2;
-    try {
-        SeqFileIn queryFile{options.queryFile.c_str()};
-        readRecords(meta1, set1, queryFile);
-    } catch(seqan::ParseError & e)
+    SimdLayout<TSimdVector> layout1;
+    SimdLayout<TSimdVector> layout2;
+    if (!readBlocks(layout1, set1, options.queryFile, options.readerThreads))
     {
         std::cerr << "Could not read query file" << std::endl;
-        std::cerr << e.what() << std::endl;
         exit(EXIT_FAILURE);
     }
-    try {
-        SeqFileIn dbFile{options.databaseFile.c_str()};
-        readRecords(meta2, set2, dbFile);
-    } catch(ParseError & e)
-    {
-        std::cerr << e.what() << std::endl;
-        exit(EXIT_FAILURE);
-    } catch(...)
+    if (!readBlocks(layout2, set2, options.databaseFile, options.readerThreads))
     {
         std::cerr << "Database: " << options.databaseFile << "\n";
         std::cerr << "Could not read database file" << std::endl;
@@ -113,14 +142,41 @@ int main(int argc, char* argv[])
 
     double start = sysTime();
     /* prepare simd vector representation of sequences. */
-    std::vector<String<TSimdVector, Alloc<OverAligned>>> blockBufferH;
-    std::vector<String<TSimdVector, Alloc<OverAligned>>> blockBufferV;
+    /* mapped layouts are used as they are. */
+    std::vector<String<TSimdVector, Alloc<OverAligned>>> transformedH;
+    std::vector<String<TSimdVector, Alloc<OverAligned>>> transformedV;
+    std::vector<TBlock> blockBufferH;
+    std::vector<TBlock> blockBufferV;
     String<TSimdVector, Alloc<OverAligned>> results;
 
-    _transform(blockBufferH, set1);
-    _transform(blockBufferV, set2);
+    if (layout1.isOpen())
+        for (size_t b = 0; b < layout1.numBlocks(); ++b)
+            blockBufferH.push_back(layout1[b]);
+    else
+        _transform(transformedH, set1);
+    if (layout2.isOpen())
+        for (size_t b = 0; b < layout2.numBlocks(); ++b)
+            blockBufferV.push_back(layout2[b]);
+    else
+        _transform(transformedV, set2);
+    for (auto const & block : transformedH)
+        blockBufferH.push_back(TBlock{begin(block, Standard()), length(block)});
+    for (auto const & block : transformedV)
+        blockBufferV.push_back(TBlock{begin(block, Standard()), length(block)});
     std::cout << "Prepare time: " << sysTime() - start << "s.\n";
 
+    /* the lanes of both sides must hold the same pairs. */
+    size_t const numSequences = (layout1.isOpen()) ? layout1.numSequences() : length(set1);
+    bool paired = (blockBufferH.size() == blockBufferV.size());
+    for (size_t b = 0; paired && b < blockBufferH.size(); ++b)
+        for (unsigned lane = 0; lane < LENGTH<TSimdVector>::VALUE; ++lane)
+            paired = paired && laneSequenceId(layout1, length(set1), b, lane) == laneSequenceId(layout2, length(set2), b, lane);
+    if (!paired)
+    {
+        std::cerr << "The lanes of query and database do not hold the same pairs. Use the same binning for both." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
     start = sysTime();
     /*
      * Define score values.
@@ -138,9 +194,6 @@ int main(int argc, char* argv[])
     String<TSimdVector, Alloc<OverAligned>> colDiag;
     String<TSimdVector, Alloc<OverAligned>> colHori;
 
-    resize(colDiag, length(blockBufferV[0]) + 1, Exact());
-    resize(colHori, length(blockBufferV[0]) + 1, Exact());
-
     /* The algorithm */
     for (unsigned i = 0; i < length(blockBufferH); ++i)
     {
@@ -148,6 +201,10 @@ int main(int argc, char* argv[])
         auto & bufferH = blockBufferH[i];
         auto & bufferV = blockBufferV[i];
 
+        // Blocks differ in length if the sequences do.
+        resize(colDiag, length(bufferV) + 1, Exact());
+        resize(colHori, length(bufferV) + 1, Exact());
+
         colDiag[0] = createVector<TSimdVector>(0);
         colHori[0] = gapOpen;
         TSimdVector colVert    = gapOpen;
@@ -189,7 +246,7 @@ int main(int argc, char* argv[])
                 // colDiag[row]    = max(tmp, max(colHori[row], colVert));
             }
         }
-        appendValue(results, colDiag[length(bufferH)]);
+        appendValue(results, colDiag[length(bufferV)]);
     }
     std::cout << "Runtime: " << sysTime() - start << "s.\n";
 
@@ -200,9 +257,17 @@ int main(int argc, char* argv[])
         std::cerr << "Could not open file << " << options.alignOut.c_str() << ">>!" << std::endl;
         exit(EXIT_FAILURE);
     }
-    std::for_each(begin(results), end(results), [&](auto & sc)
+    // Writes the scores in input order, which differs from the lane order for sorted layouts.
+    std::vector<int16_t> scores(numSequences);
+    for (size_t b = 0; b < length(results); ++b)
     {
-        for (unsigned i = 0; i < LENGTH<TSimdVector>::VALUE; ++i)
-            alignOut << sc[i] << ",\n";
-    });
+        for (unsigned lane = 0; lane < LENGTH<TSimdVector>::VALUE; ++lane)
+        {
+            uint64_t const id = laneSequenceId(layout1, length(set1), b, lane);
+            if (id != SimdLayoutHeader::NO_SEQUENCE)
+                scores[id] = results[b][lane];
+        }
+    }
+    for (auto const & sc : scores)
+        alignOut << sc << ",\n";
 }
@@ -35,6 +35,7 @@
 #pragma once
 
 #include <iostream>
+#include <vector>
 
 #include <seqan/basic.h>
 
@@ -52,6 +53,9 @@ struct Timer
 
     unsigned _rep;
 
+    // Durations of all start()/stop() pairs since the last clear().
+    std::vector<TValue> _runs;
+
     Timer() : _begin(0), _end(0), _rep(1)
     {};
 };
@@ -88,6 +92,30 @@ template <typename TValue, typename TSpec>
 inline void stop(Timer<TValue, TSpec> & timer)
 {
     timer._end = sysTime();
+    timer._runs.push_back(timer._end - timer._begin);
+}
+
+// ----------------------------------------------------------------------------
+// Function clear()
+// ----------------------------------------------------------------------------
+
+template <typename TValue, typename TSpec>
+inline void clear(Timer<TValue, TSpec> & timer)
+{
+    timer._begin = 0;
+    timer._end = 0;
+    timer._runs.clear();
+}
+
+// ----------------------------------------------------------------------------
+// Function getRuns()
+// ----------------------------------------------------------------------------
+
+template <typename TValue, typename TSpec>
+inline std::vector<TValue> const &
+getRuns(Timer<TValue, TSpec> const & timer)
+{
+    return timer._runs;
 }
 
 // ----------------------------------------------------------------------------
@@ -97,7 +125,14 @@ inline void stop(Timer<TValue, TSpec> & timer)
 template <typename TValue, typename TSpec>
 inline TValue getValue(Timer<TValue, TSpec> const & timer)
 {
-    return (timer._end - timer._begin) / timer._rep;
+    if (timer._runs.empty())
+        return (timer._end - timer._begin) / timer._rep;
+
+    // Mean over all recorded runs.
+    TValue sum = 0;
+    for (auto const & run : timer._runs)
+        sum += run;
+    return sum / timer._runs.size();
 }
 
 template <typename TValue, typename TSpec>